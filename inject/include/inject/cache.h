@@ -0,0 +1,66 @@
+#pragma once
+
+#include "memory_usage.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex> // std::call_once
+#include <type_traits>
+#include <utility>
+
+namespace inject
+{
+    // The memory used by value beyond the sizeof(T) bytes stored inline
+    template<typename T>
+    std::size_t memory_size_outside(const T& value) noexcept
+    {
+        const auto result = memory_size<T>()(value);
+        return result > sizeof(T) ? result - sizeof(T) : 0;
+    }
+
+    // Thread safe storage for an instance created on first use. The instance is created once, by the first thread to
+    // request it - any other thread requesting it meanwhile waits for that instance. T must be default constructible.
+    template<typename T>
+    struct cache
+    {
+        cache() = default;
+
+        // Only moved during registration, before any value has been cached, so the once_flag doesn't need to be transferred
+        cache(cache&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : m_value(std::move(other.m_value))
+        {
+        }
+
+        template<typename Fn>
+        T get_value(Fn&& fn)
+        {
+            if (m_is_cached.load(std::memory_order_acquire))
+            {
+                return m_value;
+            }
+
+            std::call_once(m_flag, [&]()
+            {
+                m_value = fn();
+                m_is_cached.store(true, std::memory_order_release);
+            });
+
+            return m_value;
+        }
+
+        bool has_value() const noexcept
+        {
+            return m_is_cached.load(std::memory_order_acquire);
+        }
+
+        // The memory used by the value outside of the cache, which stores sizeof(T) inline
+        std::size_t size() const
+        {
+            return has_value() ? memory_size_outside(m_value) : 0;
+        }
+
+        T m_value;
+        std::once_flag m_flag;
+        std::atomic<bool> m_is_cached = false; // Allows the memory used by the value to be read without racing its creation
+    };
+}
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "cache.h"
 #include "factory.h"
+#include "memory_usage.h"
+#include "validation.h"
 
-#include <atomic>
 #include <memory>
-#include <mutex> // std::call_once
+#include <type_traits>
+#include <utility>
 
 namespace inject
 {
@@ -20,12 +23,7 @@ namespace inject
         template<typename T, typename Fn>
         void register_cached(Fn&& fn)
         {
-            auto fn_cache = [this, fn = std::forward<Fn>(fn), cache = std::make_shared<cache<T>>()]() mutable
-            {
-                return cache->get_value([&]() { return m_factory.resolve(fn); }); // The lambda isn't stored by the call to get_value so a default capture mode of '&' is fine
-            };
-
-            return register_type<T>(std::move(fn_cache));
+            return register_type<T>(cached<T, std::decay_t<Fn>>{ {}, std::forward<Fn>(fn) });
         }
 
         template<typename T, typename Fn>
@@ -40,6 +38,35 @@ namespace inject
             return register_type<std::unique_ptr<T>>(std::forward<Fn>(fn));
         }
 
+        // Registers a function that's called, at most once, with this container to register types Ts the first time any of them is resolved
+        template<typename... Ts, typename Fn>
+        void register_lazy(Fn&& fn)
+        {
+            return m_factory.register_lazy<Ts...>([this, fn = std::forward<Fn>(fn)]() mutable
+                {
+                    fn(*this);
+                });
+        }
+
+        // Decorates the instances returned by the factory registered for T - see factory::decorate
+        template<typename T, typename... Fns>
+        void decorate(Fns&&... fns)
+        {
+            return m_factory.decorate<T>(std::forward<Fns>(fns)...);
+        }
+
+        template<typename T, typename... Fns>
+        void decorate_shared(Fns&&... fns)
+        {
+            return decorate<std::shared_ptr<T>>(std::forward<Fns>(fns)...);
+        }
+
+        template<typename T, typename... Fns>
+        void decorate_unique(Fns&&... fns)
+        {
+            return decorate<std::unique_ptr<T>>(std::forward<Fns>(fns)...);
+        }
+
         template<typename T>
         bool is_registered() const
         {
@@ -64,10 +91,16 @@ namespace inject
             return m_factory.resolve<T>();
         }
 
-        template<typename Fn>
-        auto resolve(Fn&& fn) const
+        template<typename Sig, typename... Args>
+        typename std::enable_if_t<std::is_function_v<Sig>, function_traits<Sig>>::type_return resolve(Args&&... args) const
         {
-            return m_factory.resolve(std::forward<Fn>(fn));
+            return m_factory.resolve<Sig>(std::forward<Args>(args)...);
+        }
+
+        template<typename Fn, typename... Args>
+        auto resolve(Fn&& fn, Args&&... args) const noexcept(noexcept(m_factory.resolve(std::forward<Fn>(fn), std::forward<Args>(args)...)))
+        {
+            return m_factory.resolve(std::forward<Fn>(fn), std::forward<Args>(args)...);
         }
 
         template<typename T>
@@ -82,6 +115,16 @@ namespace inject
             return resolve<std::unique_ptr<T>>();
         }
 
+        validation_result validate() const
+        {
+            return m_factory.validate();
+        }
+
+        memory_usage memory_stats() const
+        {
+            return m_factory.memory_stats();
+        }
+
         factory& get_factory() noexcept
         {
             return m_factory;
@@ -93,50 +136,31 @@ namespace inject
         }
 
     private:
-        // General case - T must be default constructible
-        template<typename T>
-        struct cache
+        // Cached factory - the cache is stored inline with the factory function rather than behind a separate allocation.
+        // The factory wraps the function so that its parameters are resolved, and recorded as dependencies, as usual.
+        template<typename T, typename Fn>
+        struct cached : cached_factory_wrapper
         {
-            template<typename Fn>
-            T get_value(Fn&& fn)
-            {
-                std::call_once(m_flag, [&]()
-                {
-                    m_value = fn();
-                });
+            using type_fn = Fn;
 
-                return m_value;
+            template<typename Resolve>
+            T operator()(Resolve&& resolve)
+            {
+                return m_cache.get_value([&]() { return resolve(m_fn); }); // The lambda isn't stored by the call to get_value so a default capture mode of '&' is fine
             }
 
-            T m_value;
-            std::once_flag m_flag;
-        };
-
-        // Specialization - std::shared_ptr<T>
-        template<typename T>
-        struct cache<std::shared_ptr<T>>
-        {
-            template<typename Fn>
-            std::shared_ptr<T> get_value(Fn&& fn)
+            bool has_cached_value() const noexcept
             {
-                std::shared_ptr<T> value = std::atomic_load(&m_value);
-
-                // Return the cached value if it exists otherwise create
-                // the shared instance and assign it to the cached value
-                if (!value)
-                {
-                    std::shared_ptr<T> value_desired = fn(); // It's possible, although unlikely, that the factory function is called by multiple threads during resolution
-
-                    if (std::atomic_compare_exchange_strong(&m_value, &value, value_desired)) // The expected shared_ptr 'value' is empty
-                    {
-                        value = std::move(value_desired); // Successfully updated m_value so ensure the new value is returned
-                    }
-                }
+                return m_cache.has_value();
+            }
 
-                return value;
+            std::size_t cached_size() const
+            {
+                return m_cache.size();
             }
 
-            std::shared_ptr<T> m_value; // Replace with std::atomic<std::shared_ptr<T>> once using C++20
+            Fn m_fn;
+            cache<T> m_cache = {};
         };
 
         factory m_factory;
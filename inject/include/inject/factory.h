@@ -1,68 +1,234 @@
 #pragma once
 
+#include "cache.h"
 #include "factory_exception.h"
 #include "function_traits.h"
+#include "memory_usage.h"
+#include "registry.h"
 #include "type_id.h"
+#include "validation.h"
 
-#include <any>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <functional>
-#include <mutex>
-#include <shared_mutex>
+#include <memory>
+#include <mutex> // std::call_once
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace inject
 {
+    // Base of a callable that wraps a factory function, such as the cache used by container. The derived type declares the
+    // type of the function as type_fn, and is invoked with a callable that resolves the parameters of the function it's
+    // passed and invokes it. Only callables derived from this base are treated as wrappers, so that a type_fn member of
+    // any other callable has no effect.
+    struct factory_wrapper
+    {
+    };
+
+    // Base of a wrapper that caches the instance it returns. The derived type reports the instance through
+    // has_cached_value and cached_size.
+    struct cached_factory_wrapper : factory_wrapper
+    {
+    };
+
+    // Notified each time a factory that caches its instance constructs it. May be called by multiple threads at once.
+    class construction_listener
+    {
+    public:
+        virtual ~construction_listener() = default;
+
+        virtual void on_constructed(type_id id) = 0;
+    };
+
     class factory
     {
     public:
+        factory() = default;
+
+        factory(const factory&) = delete;
+        factory& operator=(const factory&) = delete;
+
+        // T is either the type to register or, for a type that's resolved with runtime arguments, a function type T(Args...).
+        // In the latter case the trailing parameters of Fn receive the runtime arguments and the leading parameters are resolved.
         template<typename T, typename Fn>
         void register_type(Fn&& fn)
         {
-            using type_to = T;
-            using type_from = typename function_traits<std::remove_reference_t<Fn>>::type_return;
+            return register_invoker(type_id::get<T>(), type_id::name<T>(), std::forward<Fn>(fn), tag<typename signature<T>::type>());
+        }
 
-            static_assert(std::is_convertible_v<type_from, type_to>, "inject::factory::register_type: Template parameter Fn must be a callable type returning a type implicitly convertible to template parameter T");
+        // Registers a function that's called, at most once, to register the factories for types Ts the first time any of
+        // them is resolved. The function must only register types, resolving a type it provides would deadlock.
+        template<typename... Ts, typename Fn>
+        void register_lazy(Fn&& fn)
+        {
+            static_assert(std::is_invocable_r_v<void, Fn&>, "inject::factory::register_lazy: Template parameter Fn must be a callable type taking no arguments");
 
-            auto fn_bind = [this, fn = std::forward<Fn>(fn)]() mutable
+            std::shared_ptr<provider> fn_provider = std::make_shared<provider_impl<std::decay_t<Fn>>>(std::forward<Fn>(fn));
+
+            if (!m_providers.emplace_each({ type_id::get<Ts>()... }, fn_provider))
             {
-                return resolve(fn);
+                throw factory_exception("A provider for the specified type has already been registered");
+            }
+        }
+
+        // Replaces the factory registered for T with one that passes each instance it returns through decorators fns, in
+        // order. Each decorator takes the instance as its first parameter and returns the decorated instance, and any further
+        // parameters are resolved. Decorators passed to the same call are composed into a single invocation chain. If T was
+        // registered lazily its provider is loaded first.
+        template<typename T, typename... Fns>
+        void decorate(Fns&&... fns)
+        {
+            static_assert(!std::is_function_v<T>, "inject::factory::decorate: Template parameter T can't be a type resolved with runtime arguments");
+            static_assert(((std::is_convertible_v<typename function_traits<std::decay_t<Fns>>::type_return, T> && std::is_convertible_v<T, std::tuple_element_t<0, typename function_traits<std::decay_t<Fns>>::type_args>>) && ...), "inject::factory::decorate: Template parameter Fns must be callable types taking and returning a type implicitly convertible to template parameter T");
+
+            const invoker_base* fn_replaced = nullptr;
+
+            auto fn_decorate = [&](invoker_slot& slot)
+            {
+                fn_replaced = &check_invoker<T>(slot.get());
+
+                slot.replace([&](std::unique_ptr<invoker_base>&& fn_invoker) -> std::unique_ptr<invoker_base>
+                    {
+                        if constexpr (std::is_default_constructible_v<T> && std::is_copy_constructible_v<T>) // Cached instances are returned by copy
+                        {
+                            if (fn_invoker->is_cached())
+                            {
+                                return std::make_unique<decorated_invoker<T, true, std::decay_t<Fns>...>>(*this, std::move(fn_invoker), std::forward<Fns>(fns)...);
+                            }
+                        }
+
+                        return std::make_unique<decorated_invoker<T, false, std::decay_t<Fns>...>>(*this, std::move(fn_invoker), std::forward<Fns>(fns)...);
+                    });
             };
 
-            std::unique_lock lock(m_factory_mutex); // Write operation - unique lock must be acquired
-            auto result = m_factories.emplace(type_id::get<T>(), std::function<T()>(std::move(fn_bind)));
+            const auto id = type_id::get<T>();
 
-            if (!result.second)
+            if (!m_factories.contains(id))
             {
-                throw factory_exception("A factory for the specified type has already been registered");
+                if (auto fn_provider = m_providers.find(id))
+                {
+                    (*fn_provider)->load(); // Registers the factory to decorate
+                }
             }
+
+            if (!m_factories.replace(id, fn_decorate))
+            {
+                throw factory_exception("No factory has been registered for the specified type");
+            }
+
+            m_factories.for_each([&](type_id, const invoker_slot& slot)
+                {
+                    slot.get().unlink(*fn_replaced);
+                });
         }
 
         template<typename T>
         bool is_registered() const
         {
-            std::shared_lock lock(m_factory_mutex); // Read operation - shared lock acquired
-            return m_factories.find(type_id::get<T>()) != m_factories.end();
+            const auto id = type_id::get<T>();
+            return m_factories.contains(id) || m_providers.contains(id);
         }
 
+        // Never noexcept, even for a noexcept factory, as the type may not be registered
         template<typename T>
         T resolve() const
         {
-            auto fn_any = find_factory(type_id::get<T>());
-            auto fn = std::any_cast<std::function<T()>>(fn_any);
+            auto& fn_invoker = static_cast<invoker<T>&>(check_invoker<T>(find_invoker(type_id::get<T>())));
 
-            return fn();
+            return fn_invoker.invoke();
         }
 
-        template<typename Fn>
-        auto resolve(Fn&& fn) const
+        // Resolves a type registered as T(Args...) passing args as the runtime arguments
+        template<typename Sig, typename... Args>
+        typename std::enable_if_t<std::is_function_v<Sig>, function_traits<Sig>>::type_return resolve(Args&&... args) const
+        {
+            return resolve_invoker(check_invoker<Sig>(find_invoker(type_id::get<Sig>())), tag<Sig>(), std::forward<Args>(args)...);
+        }
+
+        // Resolves the leading parameters of fn and passes args as its trailing parameters. Only noexcept if fn is noexcept
+        // and there are no parameters to resolve, as resolving a parameter may throw.
+        template<typename Fn, typename... Args>
+        auto resolve(Fn&& fn, Args&&... args) const noexcept(sizeof...(Args) == 0 && is_noexcept_resolve<std::remove_reference_t<Fn>>)
         {
             using type_args = typename function_traits<std::remove_reference_t<Fn>>::type_args;
             using type_args_tag = tag<type_args>;
 
-            return std::apply(std::forward<Fn>(fn), resolve_args(type_args_tag()));
+            static_assert(std::tuple_size_v<type_args> >= sizeof...(Args), "inject::factory::resolve: Template parameter Fn must be a callable type with a parameter for each runtime argument");
+
+            using type_args_resolved = std::make_index_sequence<std::tuple_size_v<type_args> - sizeof...(Args)>;
+
+            return resolve_args(std::forward<Fn>(fn), nullptr, type_args_tag(), type_args_resolved(), std::forward<Args>(args)...);
+        }
+
+        // Reports any dependencies that aren't registered, or that form a cycle, before they're resolved. Each factory is
+        // also linked to the factories it depends on so that they're subsequently resolved without being looked up.
+        validation_result validate() const
+        {
+            std::unordered_map<type_id, invoker_base*> invokers;
+
+            m_factories.for_each([&](type_id id, const invoker_slot& slot)
+                {
+                    invokers.emplace(id, &slot.get());
+                });
+
+            validation_result result;
+
+            std::unordered_map<type_id, bool> visited; // False while the type is on the path being validated
+            std::vector<dependency> path;
+
+            for (const auto& [id, fn_invoker] : invokers)
+            {
+                if (visited.find(id) == visited.end())
+                {
+                    validate_invoker({ id, fn_invoker->name() }, invokers, visited, path, result);
+                }
+            }
+
+            return result;
+        }
+
+        memory_usage memory_stats() const
+        {
+            memory_usage result;
+
+            result.registry_bytes = m_factories.memory_usage() + m_providers.memory_usage();
+
+            m_factories.for_each([&](type_id id, const invoker_slot& slot)
+                {
+                    memory_usage::registration registration = { id, 0, false, false, 0 };
+                    slot.get().get_memory_usage(registration);
+
+                    result.invoker_bytes += registration.invoker_bytes;
+                    result.cached_instances += registration.is_constructed ? 1 : 0;
+                    result.cached_bytes += registration.cached_bytes;
+                    result.registrations.push_back(registration);
+                });
+
+            return result;
+        }
+
+        // Replaces the listener notified when a cached instance is constructed, or removes it if listener is null. The
+        // listener is only read when an instance is constructed, so it adds no work to a resolve that returns an existing
+        // instance. See trace.h.
+        void set_construction_listener(std::shared_ptr<construction_listener> listener)
+        {
+            const bool has_listener = listener != nullptr;
+
+            std::atomic_store(&m_listener, std::move(listener));
+            m_has_listener.store(has_listener, std::memory_order_release);
+        }
+
+        // Constructs the cached instance of the type with the specified id, if its factory caches its instance and it hasn't
+        // been constructed yet. A thread resolving the type meanwhile waits for that instance rather than constructing another.
+        void prefetch(type_id id) const
+        {
+            find_invoker(id).prefetch();
         }
 
     private:
@@ -72,33 +238,575 @@ namespace inject
         {
         };
 
+        // The signature of the invoker for a registered type - T() unless T is a function type
+        template<typename T>
+        struct signature
+        {
+            using type = T();
+        };
+
+        template<typename R, typename... Args>
+        struct signature<R(Args...)>
+        {
+            using type = R(Args...);
+        };
+
+        template<typename Fn, typename = void>
+        struct unwrap
+        {
+            using type = Fn;
+
+            static constexpr bool is_wrapper = false;
+        };
+
+        template<typename Fn>
+        struct unwrap<Fn, std::enable_if_t<std::is_base_of_v<factory_wrapper, Fn>>>
+        {
+            using type = typename Fn::type_fn;
+
+            static constexpr bool is_wrapper = true;
+        };
+
+        // A callable that has no arguments to resolve can only throw if the callable itself throws
+        template<typename Fn>
+        static constexpr bool is_noexcept_resolve = function_traits<Fn>::is_noexcept && std::tuple_size_v<typename function_traits<Fn>::type_args> == 0;
+
+        template<typename Fn>
+        using is_cached_factory = std::is_base_of<cached_factory_wrapper, Fn>;
+
+        // Type erased interface to a registered factory
+        class invoker_base
+        {
+        public:
+            invoker_base(type_id id, std::string_view name) noexcept : m_id(id), m_name(name)
+            {
+            }
+
+            virtual ~invoker_base() = default;
+
+            type_id id() const noexcept
+            {
+                return m_id;
+            }
+
+            std::string_view name() const noexcept
+            {
+                return m_name;
+            }
+
+            virtual bool is_cached() const noexcept = 0;
+
+            // Constructs the cached instance, if the factory caches its instance and it hasn't already been constructed
+            virtual void prefetch() = 0;
+
+            virtual void get_memory_usage(memory_usage::registration& registration) const = 0;
+
+            // The types resolved to invoke the factory, recorded at registration
+            virtual std::size_t dependency_count() const noexcept = 0;
+            virtual const dependency& get_dependency(std::size_t index) const noexcept = 0;
+
+            // Resolve the dependency at index through the specified invoker rather than looking it up
+            virtual void link(std::size_t index, invoker_base& fn_invoker) noexcept = 0;
+
+            // Look up any dependency resolved through the specified invoker, as it's been replaced
+            virtual void unlink(const invoker_base& fn_invoker) noexcept = 0;
+
+        private:
+            type_id m_id;
+            std::string_view m_name;
+        };
+
+        template<typename T, typename... Args>
+        class invoker : public invoker_base
+        {
+        public:
+            using invoker_base::invoker_base;
+
+            virtual T invoke(Args... args) = 0;
+        };
+
+        // Owns the invoker registered for a type. Invokers are looked up without locking, so when a type is decorated its
+        // invoker is replaced atomically, and the invoker replaced remains alive as it's owned by the one replacing it.
+        class invoker_slot
+        {
+        public:
+            explicit invoker_slot(std::unique_ptr<invoker_base> fn_invoker) noexcept : m_invoker(fn_invoker.release())
+            {
+            }
+
+            invoker_slot(const invoker_slot&) = delete;
+            invoker_slot& operator=(const invoker_slot&) = delete;
+
+            ~invoker_slot()
+            {
+                delete m_invoker.load(std::memory_order_relaxed);
+            }
+
+            invoker_base& get() const noexcept
+            {
+                return *m_invoker.load(std::memory_order_acquire);
+            }
+
+            // Replaces the invoker with the one returned by fn, which is passed ownership of the current invoker. Must be
+            // serialized with any other call to replace.
+            template<typename Fn>
+            void replace(Fn&& fn)
+            {
+                std::unique_ptr<invoker_base> fn_invoker(m_invoker.load(std::memory_order_relaxed));
+                std::unique_ptr<invoker_base> fn_replacement;
+
+                try
+                {
+                    fn_replacement = fn(std::move(fn_invoker));
+                }
+                catch (...)
+                {
+                    fn_invoker.release(); // Still owned by the slot if fn didn't take ownership before throwing
+                    throw;
+                }
+
+                m_invoker.store(fn_replacement.release(), std::memory_order_release);
+            }
+
+        private:
+            std::atomic<invoker_base*> m_invoker;
+        };
+
+        // Null until the dependency has been validated. Reset if the linked factory is replaced by a decorated factory.
+        using dependency_link = std::atomic<invoker_base*>;
+
+        template<std::size_t N>
+        static void unlink(std::array<dependency_link, N>& links, const invoker_base& fn_invoker) noexcept
+        {
+            for (auto& link : links)
+            {
+                auto expected = const_cast<invoker_base*>(&fn_invoker);
+                link.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+            }
+        }
+
+        template<typename TypeArgs, std::size_t... Is>
+        static constexpr std::array<dependency, sizeof...(Is)> make_dependencies(std::index_sequence<Is...>) noexcept
+        {
+            return { { dependency{ type_id::get<std::tuple_element_t<Is, TypeArgs>>(), type_id::name<std::tuple_element_t<Is, TypeArgs>>() }... } };
+        }
+
+        // The parameters of a decorator that are resolved - all but the first, which receives the instance being decorated
+        template<typename TypeArgs>
+        struct decorator_args;
+
+        template<typename T, typename... Ts>
+        struct decorator_args<std::tuple<T, Ts...>>
+        {
+            using type = std::tuple<Ts...>;
+        };
+
+        template<typename Fn>
+        using decorator_args_t = typename decorator_args<typename function_traits<Fn>::type_args>::type;
+
+        // Registers the factories for one or more types on demand
+        class provider
+        {
+        public:
+            virtual ~provider() = default;
+
+            void load()
+            {
+                std::call_once(m_flag, [this]() { invoke(); }); // If the function throws the flag remains unset, so the next resolve retries
+            }
+
+        private:
+            virtual void invoke() = 0;
+
+            std::once_flag m_flag;
+        };
+
+        // Stores the callable inline, like invoker_impl, so the callable only has to be move constructible
+        template<typename Fn>
+        class provider_impl final : public provider
+        {
+        public:
+            template<typename FnArg>
+            explicit provider_impl(FnArg&& fn) : m_fn(std::forward<FnArg>(fn))
+            {
+            }
+
+        private:
+            void invoke() override
+            {
+                m_fn();
+            }
+
+            Fn m_fn;
+        };
+
+        // Stores the callable inline and invokes it in place, so the callable only has to be move constructible.
+        // As a registered factory can be resolved by multiple threads at once the callable must support concurrent invocation.
+        template<typename Fn, typename T, typename... Args>
+        class invoker_impl final : public invoker<T, Args...>
+        {
+        public:
+            using type_fn = typename unwrap<Fn>::type;
+            using type_args = typename function_traits<type_fn>::type_args;
+
+            static constexpr std::size_t resolved_count = std::tuple_size_v<type_args> - sizeof...(Args);
+
+            template<typename FnArg>
+            invoker_impl(const factory& owner, type_id id, std::string_view name, FnArg&& fn) : invoker<T, Args...>(id, name), m_factory(owner), m_fn(std::forward<FnArg>(fn))
+            {
+            }
+
+            T invoke(Args... args) override
+            {
+                if constexpr (unwrap<Fn>::is_wrapper)
+                {
+                    return m_fn([&](type_fn& fn)
+                        {
+                            auto result = m_factory.resolve_linked(fn, m_links, std::forward<Args>(args)...);
+
+                            if constexpr (is_cached_factory<Fn>::value)
+                            {
+                                m_factory.record(this->id()); // Only called when the cached instance is constructed
+                            }
+
+                            return result;
+                        });
+                }
+                else
+                {
+                    return m_factory.resolve_linked(m_fn, m_links, std::forward<Args>(args)...);
+                }
+            }
+
+            bool is_cached() const noexcept override
+            {
+                return is_cached_factory<Fn>::value;
+            }
+
+            void prefetch() override
+            {
+                if constexpr (sizeof...(Args) == 0 && is_cached_factory<Fn>::value)
+                {
+                    invoke();
+                }
+            }
+
+            std::size_t dependency_count() const noexcept override
+            {
+                return s_dependencies.size();
+            }
+
+            const dependency& get_dependency(std::size_t index) const noexcept override
+            {
+                return s_dependencies[index];
+            }
+
+            void link(std::size_t index, invoker_base& fn_invoker) noexcept override
+            {
+                m_links[index].store(&fn_invoker, std::memory_order_release);
+            }
+
+            void unlink(const invoker_base& fn_invoker) noexcept override
+            {
+                factory::unlink(m_links, fn_invoker);
+            }
+
+            void get_memory_usage(memory_usage::registration& registration) const override
+            {
+                registration.invoker_bytes = sizeof(*this);
+
+                if constexpr (is_cached_factory<Fn>::value)
+                {
+                    registration.is_cached = true;
+                    registration.is_constructed = m_fn.has_cached_value();
+                    registration.cached_bytes = m_fn.cached_size();
+                }
+            }
+
+        private:
+            static constexpr auto s_dependencies = make_dependencies<type_args>(std::make_index_sequence<resolved_count>());
+
+            const factory& m_factory;
+            Fn m_fn;
+            std::array<dependency_link, resolved_count> m_links = {};
+        };
+
+        struct no_cache
+        {
+        };
+
+        // Applies decorators, in order, to the instances returned by a previously registered factory. The decorators are
+        // stored by type and invoked directly, so the only indirection is the call to the previous factory. If the
+        // previous factory caches its instance then so does this one, so a cached instance is only decorated once.
+        template<typename T, bool IsCached, typename... Fns>
+        class decorated_invoker final : public invoker<T>
+        {
+        public:
+            using type_args = decltype(std::tuple_cat(std::declval<decorator_args_t<Fns>>()...));
+
+            template<typename... FnArgs>
+            decorated_invoker(const factory& owner, std::unique_ptr<invoker_base>&& inner, FnArgs&&... fns) : invoker<T>(inner->id(), inner->name()), m_factory(owner), m_fns(std::forward<FnArgs>(fns)...), m_inner(std::move(inner))
+            {
+            }
+
+            T invoke() override
+            {
+                if constexpr (IsCached)
+                {
+                    return m_cache.get_value([&]() { return decorate<0>(static_cast<invoker<T>&>(*m_inner).invoke()); });
+                }
+                else
+                {
+                    return decorate<0>(static_cast<invoker<T>&>(*m_inner).invoke());
+                }
+            }
+
+            bool is_cached() const noexcept override
+            {
+                return IsCached;
+            }
+
+            void prefetch() override
+            {
+                if constexpr (IsCached)
+                {
+                    invoke(); // The previous factory records the type when it constructs the instance being decorated
+                }
+            }
+
+            std::size_t dependency_count() const noexcept override
+            {
+                return m_inner->dependency_count() + s_dependencies.size();
+            }
+
+            const dependency& get_dependency(std::size_t index) const noexcept override
+            {
+                const auto inner_count = m_inner->dependency_count();
+                return index < inner_count ? m_inner->get_dependency(index) : s_dependencies[index - inner_count];
+            }
+
+            void link(std::size_t index, invoker_base& fn_invoker) noexcept override
+            {
+                if (const auto inner_count = m_inner->dependency_count(); index < inner_count)
+                {
+                    m_inner->link(index, fn_invoker);
+                }
+                else
+                {
+                    m_links[index - inner_count].store(&fn_invoker, std::memory_order_release);
+                }
+            }
+
+            void unlink(const invoker_base& fn_invoker) noexcept override
+            {
+                m_inner->unlink(fn_invoker);
+                factory::unlink(m_links, fn_invoker);
+            }
+
+            void get_memory_usage(memory_usage::registration& registration) const override
+            {
+                m_inner->get_memory_usage(registration);
+
+                registration.invoker_bytes += sizeof(*this);
+
+                if constexpr (IsCached)
+                {
+                    registration.cached_bytes += m_cache.size(); // The decorated instance, in addition to the instance decorated
+                }
+            }
+
+        private:
+            template<std::size_t I>
+            T decorate(T value)
+            {
+                if constexpr (I == sizeof...(Fns))
+                {
+                    return value;
+                }
+                else
+                {
+                    return decorate<I + 1>(m_factory.resolve_decorator(std::get<I>(m_fns), m_links.data() + s_offsets[I], std::move(value)));
+                }
+            }
+
+            // The index of each decorator's first resolved parameter in the combined dependencies
+            static constexpr std::array<std::size_t, sizeof...(Fns)> make_offsets() noexcept
+            {
+                std::array<std::size_t, sizeof...(Fns)> result = {};
+                std::size_t counts[] = { std::tuple_size_v<decorator_args_t<Fns>>..., 0 };
+
+                for (std::size_t i = 1; i < result.size(); ++i)
+                {
+                    result[i] = result[i - 1] + counts[i - 1];
+                }
+
+                return result;
+            }
+
+            static constexpr auto s_dependencies = make_dependencies<type_args>(std::make_index_sequence<std::tuple_size_v<type_args>>());
+            static constexpr auto s_offsets = make_offsets();
+
+            const factory& m_factory;
+            std::tuple<Fns...> m_fns;
+            std::conditional_t<IsCached, cache<T>, no_cache> m_cache = {};
+            std::array<dependency_link, std::tuple_size_v<type_args>> m_links = {};
+            std::unique_ptr<invoker_base> m_inner; // Initialized last so that inner is only moved once nothing else can throw
+        };
+
         template<typename T>
-        T resolve_arg() const
+        T resolve_arg(const dependency_link* links, std::size_t index) const
         {
+            if (links)
+            {
+                if (auto fn_invoker = links[index].load(std::memory_order_acquire))
+                {
+                    return static_cast<invoker<T>&>(*fn_invoker).invoke(); // Linked by validate, which compares the names, so known to be registered for T
+                }
+            }
+
             return resolve<T>();
         }
 
-        template<typename... Ts>
-        std::tuple<Ts...> resolve_args(tag<std::tuple<Ts...>>) const
+        template<typename Fn, typename... Ts, std::size_t... Is, typename... Args>
+        auto resolve_args(Fn&& fn, [[maybe_unused]] const dependency_link* links, tag<std::tuple<Ts...>>, std::index_sequence<Is...>, Args&&... args) const
+        {
+            return std::invoke(std::forward<Fn>(fn), resolve_arg<std::tuple_element_t<Is, std::tuple<Ts...>>>(links, Is)..., std::forward<Args>(args)...);
+        }
+
+        template<typename Fn, typename T, typename... Ts, std::size_t... Is>
+        T resolve_decorator(Fn& fn, [[maybe_unused]] const dependency_link* links, tag<std::tuple<Ts...>>, std::index_sequence<Is...>, T&& value) const
+        {
+            return std::invoke(fn, std::move(value), resolve_arg<std::tuple_element_t<Is, std::tuple<Ts...>>>(links, Is)...);
+        }
+
+        template<typename Fn, typename T>
+        T resolve_decorator(Fn& fn, const dependency_link* links, T&& value) const
+        {
+            using type_args = decorator_args_t<Fn>;
+
+            return resolve_decorator(fn, links, tag<type_args>(), std::make_index_sequence<std::tuple_size_v<type_args>>(), std::move(value));
+        }
+
+        template<typename Fn, std::size_t N, typename... Args>
+        auto resolve_linked(Fn& fn, const std::array<dependency_link, N>& links, Args&&... args) const
         {
-            return std::make_tuple(resolve_arg<Ts>()...);
+            using type_args = typename function_traits<Fn>::type_args;
+
+            return resolve_args(fn, links.data(), tag<type_args>(), std::make_index_sequence<N>(), std::forward<Args>(args)...);
         }
 
-        std::any find_factory(type_id id) const
+        template<typename T, typename... Args, typename... ArgsFwd>
+        T resolve_invoker(invoker_base& fn_invoker_base, tag<T(Args...)>, ArgsFwd&&... args) const
         {
-            std::shared_lock lock(m_factory_mutex); // Read operation - shared lock acquired
+            auto& fn_invoker = static_cast<invoker<T, Args...>&>(fn_invoker_base); // Checked by check_invoker
+
+            return fn_invoker.invoke(std::forward<ArgsFwd>(args)...);
+        }
+
+        template<typename Fn, typename T, typename... Args>
+        void register_invoker(type_id id, std::string_view name, Fn&& fn, tag<T(Args...)>)
+        {
+            using type_fn = typename unwrap<std::decay_t<Fn>>::type;
+            using type_to = T;
+            using type_from = typename function_traits<type_fn>::type_return;
+            using type_args = typename function_traits<type_fn>::type_args;
 
-            if (auto it = m_factories.find(id); it != m_factories.end())
+            static_assert(std::is_convertible_v<type_from, type_to>, "inject::factory::register_type: Template parameter Fn must be a callable type returning a type implicitly convertible to template parameter T");
+            static_assert(std::tuple_size_v<type_args> >= sizeof...(Args), "inject::factory::register_type: Template parameter Fn must be a callable type with a trailing parameter for each runtime argument of template parameter T");
+
+            auto fn_invoker = std::make_unique<invoker_impl<std::decay_t<Fn>, T, Args...>>(*this, id, name, std::forward<Fn>(fn));
+
+            if (!m_factories.emplace(id, std::move(fn_invoker)))
+            {
+                throw factory_exception("A factory for the specified type has already been registered");
+            }
+        }
+
+        void validate_invoker(const dependency& dependent, const std::unordered_map<type_id, invoker_base*>& invokers, std::unordered_map<type_id, bool>& visited, std::vector<dependency>& path, validation_result& result) const
+        {
+            auto fn_invoker = invokers.at(dependent.id);
+
+            visited[dependent.id] = false;
+            path.push_back(dependent);
+
+            for (std::size_t i = 0, count = fn_invoker->dependency_count(); i < count; ++i)
+            {
+                const auto& required = fn_invoker->get_dependency(i);
+
+                if (auto it = invokers.find(required.id); it != invokers.end() && it->second->name() == required.name)
+                {
+                    fn_invoker->link(i, *it->second);
+
+                    if (auto it_visited = visited.find(required.id); it_visited == visited.end())
+                    {
+                        validate_invoker(required, invokers, visited, path, result);
+                    }
+                    else if (!it_visited->second)
+                    {
+                        auto it_path = std::find_if(path.begin(), path.end(), [&](const dependency& value) { return value.id == required.id; });
+                        result.cycles.emplace_back(it_path, path.end());
+                    }
+                }
+                else if (!m_providers.contains(required.id))
+                {
+                    result.missing.push_back({ dependent, required });
+                }
+            }
+
+            path.pop_back();
+            visited[dependent.id] = true;
+        }
+
+        void record(type_id id) const
+        {
+            if (m_has_listener.load(std::memory_order_acquire)) // Avoids the lock std::atomic_load may take when there's no listener
+            {
+                if (auto listener = std::atomic_load(&m_listener))
+                {
+                    listener->on_constructed(id);
+                }
+            }
+        }
+
+        // The id of a type with a portable id is a hash of its name, so the name is compared before the invoker is cast to
+        // the type it was registered for, in case the names of two types have the same hash.
+        template<typename T>
+        static invoker_base& check_invoker(invoker_base& fn_invoker)
+        {
+            constexpr auto name = type_id::name<T>();
+
+            if (fn_invoker.name().data() != name.data() && fn_invoker.name() != name)
+            {
+                throw factory_exception("The factory registered for the specified type's id is for a different type");
+            }
+
+            return fn_invoker;
+        }
+
+        invoker_base& find_invoker(type_id id) const
+        {
+            if (auto slot = m_factories.find(id))
             {
-                return it->second;
+                return slot->get();
+            }
+
+            if (auto fn_provider = m_providers.find(id))
+            {
+                (*fn_provider)->load();
+
+                if (auto slot = m_factories.find(id))
+                {
+                    return slot->get();
+                }
             }
 
             throw factory_exception("No factory has been registered for the specified type");
         }
 
-        mutable std::shared_mutex m_factory_mutex;
+        registry<invoker_slot> m_factories;
+        registry<std::shared_ptr<provider>> m_providers; // Shared by each of the types the provider registers
 
-        // Store std::any, rather than std::function<std::any(void)>, as std::any requires its contained value to be copy constructible
-        std::unordered_map<type_id, std::any> m_factories;
+        std::shared_ptr<construction_listener> m_listener;
+        std::atomic<bool> m_has_listener = false;
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
 
 namespace inject
 {
@@ -10,5 +11,9 @@ namespace inject
         explicit factory_exception(const char* message) : std::runtime_error(message)
         {
         }
+
+        explicit factory_exception(const std::string& message) : std::runtime_error(message)
+        {
+        }
     };
 }
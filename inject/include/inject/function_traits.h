@@ -10,6 +10,8 @@ namespace inject
         using type_return = R;
         using type_args = std::tuple<Args...>;
 
+        static constexpr bool is_noexcept = false;
+
         template<std::size_t Idx>
         using type_arg = std::tuple_element_t<Idx, type_args>;
     };
@@ -43,4 +45,32 @@ namespace inject
     struct function_traits<R(T::*)(Args...) const> : function_traits_base<R, Args...>
     {
     };
+
+    // Specialization - noexcept function
+    template<typename R, typename... Args>
+    struct function_traits<R(Args...) noexcept> : function_traits<R(Args...)>
+    {
+        static constexpr bool is_noexcept = true;
+    };
+
+    // Specialization - Pointer to noexcept function
+    template<typename R, typename... Args>
+    struct function_traits<R(*)(Args...) noexcept> : function_traits<R(*)(Args...)>
+    {
+        static constexpr bool is_noexcept = true;
+    };
+
+    // Specialization - Pointer to noexcept member function
+    template<typename T, typename R, typename... Args>
+    struct function_traits<R(T::*)(Args...) noexcept> : function_traits<R(T::*)(Args...)>
+    {
+        static constexpr bool is_noexcept = true;
+    };
+
+    // Specialization - Pointer to const noexcept member function
+    template<typename T, typename R, typename... Args>
+    struct function_traits<R(T::*)(Args...) const noexcept> : function_traits<R(T::*)(Args...) const>
+    {
+        static constexpr bool is_noexcept = true;
+    };
 }
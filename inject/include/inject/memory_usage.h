@@ -0,0 +1,90 @@
+#pragma once
+
+#include "type_id.h"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace inject
+{
+    // Whether sizeof(T) is the size of an instance of T - false if T is incomplete, void or abstract
+    template<typename T, typename = void>
+    struct is_size_known : std::false_type
+    {
+    };
+
+    template<typename T>
+    struct is_size_known<T, std::void_t<decltype(sizeof(T))>> : std::bool_constant<!std::is_abstract_v<T>>
+    {
+    };
+
+    // Returns the number of bytes used by a cached instance. Specialize for types that own dynamically allocated memory,
+    // or for interfaces whose implementations are larger than the interface itself. Unless specialized, memory_size
+    // can't be invoked for a type whose size isn't known, so the memory used by an instance owned through a pointer to
+    // such a type isn't reported.
+    template<typename T>
+    struct memory_size
+    {
+        template<typename U = T, std::enable_if_t<is_size_known<U>::value, int> = 0>
+        std::size_t operator()(const T&) const noexcept
+        {
+            return sizeof(T);
+        }
+    };
+
+    // The memory used by the instance a pointer owns, or zero if it can't be measured
+    template<typename T, typename Pointer>
+    std::size_t memory_size_pointee(const Pointer& value) noexcept
+    {
+        if constexpr (std::is_invocable_v<memory_size<T>, std::add_lvalue_reference_t<const T>>)
+        {
+            return value ? memory_size<T>()(*value) : 0;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    // Specialization - std::shared_ptr<T> - excludes the control block as its size depends on how the instance was created
+    template<typename T>
+    struct memory_size<std::shared_ptr<T>>
+    {
+        std::size_t operator()(const std::shared_ptr<T>& value) const noexcept
+        {
+            return sizeof(value) + memory_size_pointee<T>(value);
+        }
+    };
+
+    // Specialization - std::unique_ptr<T>
+    template<typename T, typename Deleter>
+    struct memory_size<std::unique_ptr<T, Deleter>>
+    {
+        std::size_t operator()(const std::unique_ptr<T, Deleter>& value) const noexcept
+        {
+            return sizeof(value) + memory_size_pointee<T>(value);
+        }
+    };
+
+    // Memory used by a container. Sizes of the registry structures are estimates as the layout of the standard containers isn't specified.
+    struct memory_usage
+    {
+        struct registration
+        {
+            type_id id;
+            std::size_t invoker_bytes; // Type erased factory, including the factory's captures and the inline storage of any cached instance
+            bool is_cached;
+            bool is_constructed; // Whether the cached instance has been created
+            std::size_t cached_bytes; // Memory used by the cached instance outside its inline storage, so it's not counted twice
+        };
+
+        std::size_t registry_bytes = 0; // Shards, buckets and nodes used to look up factories
+        std::size_t invoker_bytes = 0;
+        std::size_t cached_instances = 0;
+        std::size_t cached_bytes = 0;
+
+        std::vector<registration> registrations;
+    };
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "container.h"
+#include "factory_exception.h"
+
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+// Excludes the min and max macros, and the rarely used APIs, from the translation unit that includes this header
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#define INJECT_UNDEF_NOMINMAX
+#endif
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#define INJECT_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#if defined(INJECT_UNDEF_NOMINMAX)
+#undef NOMINMAX
+#undef INJECT_UNDEF_NOMINMAX
+#endif
+#if defined(INJECT_UNDEF_WIN32_LEAN_AND_MEAN)
+#undef WIN32_LEAN_AND_MEAN
+#undef INJECT_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#else
+#include <dlfcn.h>
+#endif
+
+// Exports a module's entry point, which must be declared as: INJECT_MODULE_EXPORT void inject_register_module(inject::container& container)
+#if defined(_WIN32)
+#define INJECT_MODULE_EXPORT extern "C" __declspec(dllexport)
+#else
+#define INJECT_MODULE_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace inject
+{
+    // A shared library that registers types with a container through its entry point
+    class module
+    {
+    public:
+        using entry_point = void(container&);
+
+        static constexpr const char* entry_point_name = "inject_register_module";
+
+        explicit module(std::string path) : m_path(std::move(path))
+        {
+        }
+
+        // Loads the shared library and calls its entry point. The library is never unloaded as the factories it registers refer to its code.
+        void load(container& container) const
+        {
+#if defined(_WIN32)
+            auto handle = ::LoadLibraryA(m_path.c_str());
+#else
+            auto handle = ::dlopen(m_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+
+            if (!handle)
+            {
+                throw factory_exception("The module " + m_path + " could not be loaded: " + get_last_error());
+            }
+
+#if defined(_WIN32)
+            auto fn = reinterpret_cast<entry_point*>(::GetProcAddress(handle, entry_point_name));
+#else
+            auto fn = reinterpret_cast<entry_point*>(::dlsym(handle, entry_point_name));
+#endif
+
+            if (!fn)
+            {
+#if defined(_WIN32)
+                ::FreeLibrary(handle);
+#else
+                ::dlclose(handle);
+#endif
+                throw factory_exception("The module " + m_path + " doesn't export an entry point");
+            }
+
+            fn(container);
+        }
+
+    private:
+        // The reason the last call to load a library failed, as reported by the operating system
+        static std::string get_last_error()
+        {
+#if defined(_WIN32)
+            char* buffer = nullptr;
+            const auto size = ::FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, ::GetLastError(), 0, reinterpret_cast<char*>(&buffer), 0, nullptr);
+
+            std::string result = size != 0 ? std::string(buffer, size) : "Unknown error";
+            ::LocalFree(buffer);
+
+            return result;
+#else
+            auto result = ::dlerror();
+            return result ? result : "Unknown error";
+#endif
+        }
+
+        std::string m_path;
+    };
+
+    // Declares that types Ts are provided by the module at path. The module is loaded the first time any of the types is resolved.
+    template<typename... Ts>
+    void register_module(container& container, std::string path)
+    {
+        container.register_lazy<Ts...>([module = inject::module(std::move(path))](inject::container& target)
+            {
+                module.load(target);
+            });
+    }
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "type_id.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional> // std::hash
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// The mutex type guarding each shard against concurrent writers. It can be overridden, consistently in every translation
+// unit of a program, to instrument locking. The type must meet the SharedMutex requirements.
+#ifndef INJECT_SHARED_MUTEX
+#define INJECT_SHARED_MUTEX std::shared_mutex
+#endif
+
+namespace inject
+{
+    // Associative container keyed by type_id that supports concurrent lookups and insertions.
+    // Entries are spread across independently locked shards. Each shard publishes its entries
+    // in an open addressing table that find probes without locking, so readers never write to
+    // shared memory, even when every thread looks up the same type. Entries can't be erased,
+    // so a pointer returned by find remains valid for the lifetime of the registry.
+    template<typename T, std::size_t ShardCount = 16>
+    class registry
+    {
+    public:
+        static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0, "inject::registry: Template parameter ShardCount must be a power of two");
+
+        template<typename... Args>
+        bool emplace(type_id id, Args&&... args)
+        {
+            auto& target_shard = m_shards[shard_index(id)];
+
+            std::unique_lock lock(target_shard.mutex); // Write operation - unique lock must be acquired
+
+            if (target_shard.values.count(id) != 0)
+            {
+                return false;
+            }
+
+            reserve(target_shard, target_shard.values.size() + 1);
+            insert(*target_shard.tables.back(), *target_shard.values.try_emplace(id, std::forward<Args>(args)...).first);
+
+            return true;
+        }
+
+        // Inserts an entry, copied from value, for each of ids. Nothing is inserted if any of ids already has an entry, or
+        // if ids contains duplicates. The shards of ids are locked in order so that concurrent calls can't deadlock.
+        bool emplace_each(std::initializer_list<type_id> ids, const T& value)
+        {
+            std::array<std::unique_lock<INJECT_SHARED_MUTEX>, ShardCount> locks;
+
+            for (auto id : ids)
+            {
+                locks[shard_index(id)] = std::unique_lock(m_shards[shard_index(id)].mutex, std::defer_lock);
+            }
+
+            for (auto& lock : locks)
+            {
+                if (lock.mutex())
+                {
+                    lock.lock(); // Write operation - unique lock must be acquired
+                }
+            }
+
+            for (auto it = ids.begin(); it != ids.end(); ++it)
+            {
+                if (m_shards[shard_index(*it)].values.count(*it) != 0 || std::find(ids.begin(), it, *it) != it)
+                {
+                    return false;
+                }
+            }
+
+            for (auto id : ids)
+            {
+                auto& target_shard = m_shards[shard_index(id)];
+                reserve(target_shard, target_shard.values.size() + static_cast<std::size_t>(std::count_if(ids.begin(), ids.end(), [&](type_id other) { return shard_index(other) == shard_index(id); })));
+            }
+
+            std::vector<const std::pair<const type_id, T>*> entries;
+            entries.reserve(ids.size());
+
+            try
+            {
+                for (auto id : ids)
+                {
+                    entries.push_back(&*m_shards[shard_index(id)].values.try_emplace(id, value).first);
+                }
+            }
+            catch (...)
+            {
+                for (auto entry : entries)
+                {
+                    const auto id = entry->first; // Copied as the key is destroyed with the entry
+                    m_shards[shard_index(id)].values.erase(id); // Not yet published so readers can't have found it
+                }
+
+                throw;
+            }
+
+            for (auto entry : entries)
+            {
+                insert(*m_shards[shard_index(entry->first)].tables.back(), *entry);
+            }
+
+            return true;
+        }
+
+        bool contains(type_id id) const noexcept
+        {
+            return find(id) != nullptr;
+        }
+
+        // Lock free - the entry is found once the call to emplace that inserted it has returned
+        const T* find(type_id id) const noexcept
+        {
+            const auto& target_shard = m_shards[shard_index(id)];
+
+            if (auto fn_table = target_shard.published.load(std::memory_order_acquire))
+            {
+                for (auto i = slot_index(id, *fn_table); ; i = (i + 1) & fn_table->mask)
+                {
+                    auto entry = fn_table->slots[i].load(std::memory_order_acquire);
+
+                    if (!entry)
+                    {
+                        break;
+                    }
+
+                    if (entry->first == id)
+                    {
+                        return &entry->second; // Node based container so the address is stable across rehashing
+                    }
+                }
+            }
+
+            return nullptr;
+        }
+
+        // Calls fn(T&), while the entry's shard is exclusively locked, if there's an entry for the specified type. As
+        // readers don't lock, fn must only make modifications that are safe to observe concurrently, such as storing to
+        // an atomic. Concurrent calls to replace for the same entry are serialized.
+        template<typename Fn>
+        bool replace(type_id id, Fn&& fn)
+        {
+            auto& target_shard = m_shards[shard_index(id)];
+
+            std::unique_lock lock(target_shard.mutex); // Write operation - unique lock must be acquired
+
+            if (auto it = target_shard.values.find(id); it != target_shard.values.end())
+            {
+                fn(it->second);
+                return true;
+            }
+
+            return false;
+        }
+
+        // Calls fn(type_id, const T&) for each entry. Entries added concurrently may or may not be visited.
+        template<typename Fn>
+        void for_each(Fn&& fn) const
+        {
+            for (const auto& current_shard : m_shards)
+            {
+                std::shared_lock lock(current_shard.mutex); // Read operation - shared lock acquired
+
+                for (const auto& [id, value] : current_shard.values)
+                {
+                    fn(id, value);
+                }
+            }
+        }
+
+        // Estimated number of bytes used by the registry, excluding any memory owned by the values
+        std::size_t memory_usage() const
+        {
+            std::size_t result = sizeof(*this);
+
+            for (const auto& current_shard : m_shards)
+            {
+                std::shared_lock lock(current_shard.mutex); // Read operation - shared lock acquired
+                result += current_shard.values.bucket_count() * sizeof(void*) + current_shard.values.size() * node_size;
+
+                for (const auto& fn_table : current_shard.tables)
+                {
+                    result += sizeof(table) + (fn_table->mask + 1) * sizeof(slot);
+                }
+            }
+
+            return result;
+        }
+
+        static std::size_t shard_index(type_id id) noexcept
+        {
+            return std::hash<type_id>()(id) & (ShardCount - 1);
+        }
+
+    private:
+        using slot = std::atomic<const std::pair<const type_id, T>*>;
+
+        // Open addressing table of pointers to the shard's entries. Slots are only ever set, never cleared, so a reader
+        // that probes a slot that's set concurrently either sees the entry or stops at the empty slot.
+        struct table
+        {
+            explicit table(std::size_t capacity) : mask(capacity - 1), slots(new slot[capacity]())
+            {
+            }
+
+            std::size_t mask;
+            std::unique_ptr<slot[]> slots;
+        };
+
+        static constexpr std::size_t min_table_capacity = 8;
+
+        // The low bits of the hash select the shard, so use the remaining bits to select the slot
+        static std::size_t slot_index(type_id id, const table& fn_table) noexcept
+        {
+            return (std::hash<type_id>()(id) / ShardCount) & fn_table.mask;
+        }
+
+        static void insert(table& fn_table, const std::pair<const type_id, T>& entry) noexcept
+        {
+            auto i = slot_index(entry.first, fn_table);
+
+            while (fn_table.slots[i].load(std::memory_order_relaxed))
+            {
+                i = (i + 1) & fn_table.mask;
+            }
+
+            fn_table.slots[i].store(&entry, std::memory_order_release);
+        }
+
+        static constexpr std::size_t cache_line_size = 64; // Avoid std::hardware_destructive_interference_size as its value isn't ABI stable
+
+        // A node holds the entry, the pointer to the next node and, typically, the cached hash code
+        static constexpr std::size_t node_size = sizeof(std::pair<const type_id, T>) + sizeof(void*) + sizeof(std::size_t);
+
+        // Aligned to a cache line so that writers to adjacent shards don't false share
+        struct alignas(cache_line_size) shard
+        {
+            mutable INJECT_SHARED_MUTEX mutex;
+            std::unordered_map<type_id, T> values;
+            std::atomic<const table*> published = nullptr;
+            std::vector<std::unique_ptr<table>> tables; // The published table and those it replaced, which readers may still be probing
+        };
+
+        // Called with the shard exclusively locked, before entries are inserted, so that they can then be published without
+        // failing. The table is kept at most half full so that probes are short, and is replaced by a larger table when it
+        // would be exceeded. The tables replaced are only freed with the registry, which at most doubles the memory used by
+        // the published table.
+        static void reserve(shard& target, std::size_t count)
+        {
+            auto fn_table = target.tables.empty() ? nullptr : target.tables.back().get();
+            auto capacity = fn_table ? fn_table->mask + 1 : min_table_capacity;
+
+            if (fn_table && count * 2 <= capacity)
+            {
+                return;
+            }
+
+            while (count * 2 > capacity)
+            {
+                capacity *= 2;
+            }
+
+            auto fn_table_new = std::make_unique<table>(capacity);
+
+            for (const auto& value : target.values)
+            {
+                insert(*fn_table_new, value);
+            }
+
+            target.tables.push_back(std::move(fn_table_new));
+            target.published.store(target.tables.back().get(), std::memory_order_release);
+        }
+
+        std::array<shard, ShardCount> m_shards;
+    };
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "container.h"
+#include "factory_exception.h"
+#include "type_id.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace inject
+{
+    // The cached types constructed while a trace was recorded, in the order their construction completed. As a type_id is
+    // the same in every run of the program, a trace saved by one run can be replayed by the next to construct the cached
+    // instances before they're resolved.
+    class resolution_trace
+    {
+    public:
+        resolution_trace() = default;
+
+        explicit resolution_trace(std::vector<type_id> types) : m_types(std::move(types))
+        {
+        }
+
+        const std::vector<type_id>& types() const noexcept
+        {
+            return m_types;
+        }
+
+        // Writes the trace as a header followed by the id of each type. Types whose id isn't portable are omitted. The trace
+        // is written to a temporary file that then replaces the file at path, so a save that fails, or a program that exits
+        // while saving, leaves any previous trace intact.
+        void save(const std::string& path) const
+        {
+            const auto path_temp = path + ".tmp";
+
+            std::error_code error = std::make_error_code(std::errc::io_error);
+
+            if (write(path_temp))
+            {
+                std::filesystem::rename(path_temp, path, error); // Replaces any existing file
+            }
+
+            if (error)
+            {
+                std::filesystem::remove(path_temp, error);
+                throw factory_exception("The trace could not be saved");
+            }
+        }
+
+        // Returns an empty trace if there's no file at path, as there won't be until a trace has been saved, if the file
+        // isn't a complete trace, or if the trace was saved by a build of the program that computes type_id differently.
+        // A trace only affects how soon instances are constructed, so one that can't be read is ignored.
+        static resolution_trace load(const std::string& path)
+        {
+            std::ifstream stream(path, std::ios::binary);
+
+            header value = {};
+
+            if (!stream.read(reinterpret_cast<char*>(&value), sizeof(value)) || std::memcmp(value.magic, "INJT", sizeof(value.magic)) != 0)
+            {
+                return {};
+            }
+
+            if (value.version != version || value.id_size != sizeof(std::size_t))
+            {
+                return {};
+            }
+
+            std::vector<type_id> types;
+
+            for (std::uint64_t i = 0; i < value.count; ++i)
+            {
+                std::size_t id = 0;
+
+                if (!stream.read(reinterpret_cast<char*>(&id), sizeof(id)))
+                {
+                    return {};
+                }
+
+                types.push_back(type_id(id, nullptr));
+            }
+
+            return resolution_trace(std::move(types));
+        }
+
+    private:
+        static constexpr std::uint16_t version = 1;
+
+        // Laid out without padding so that every byte written is initialized
+        struct header
+        {
+            char magic[4];
+            std::uint16_t version;
+            std::uint16_t id_size;
+            std::uint64_t count;
+        };
+
+        bool write(const std::string& path) const
+        {
+            std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+            const auto count = std::count_if(m_types.begin(), m_types.end(), [](type_id type) { return type.is_portable(); });
+            const header value = { { 'I', 'N', 'J', 'T' }, version, static_cast<std::uint16_t>(sizeof(std::size_t)), static_cast<std::uint64_t>(count) };
+
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+
+            for (auto type : m_types)
+            {
+                if (type.is_portable())
+                {
+                    stream.write(reinterpret_cast<const char*>(&type.id), sizeof(type.id));
+                }
+            }
+
+            stream.close();
+
+            return !stream.fail();
+        }
+
+        std::vector<type_id> m_types;
+    };
+
+    // Records each cached type whose instance a container constructs, from construction until stop is called. Only one
+    // recorder can be active for a container at a time.
+    class trace_recorder
+    {
+    public:
+        explicit trace_recorder(container& container) : m_container(container), m_listener(std::make_shared<listener>())
+        {
+            m_container.get_factory().set_construction_listener(m_listener);
+        }
+
+        trace_recorder(const trace_recorder&) = delete;
+        trace_recorder& operator=(const trace_recorder&) = delete;
+
+        ~trace_recorder()
+        {
+            if (!m_is_stopped)
+            {
+                m_container.get_factory().set_construction_listener(nullptr);
+            }
+        }
+
+        resolution_trace stop()
+        {
+            if (!m_is_stopped)
+            {
+                m_container.get_factory().set_construction_listener(nullptr);
+                m_is_stopped = true;
+            }
+
+            return m_listener->stop();
+        }
+
+    private:
+        class listener final : public construction_listener
+        {
+        public:
+            void on_constructed(type_id id) override
+            {
+                std::lock_guard lock(m_mutex);
+
+                if (!m_is_stopped) // Each cached instance is constructed once, so each type is recorded at most once
+                {
+                    m_types.push_back(id);
+                }
+            }
+
+            // Ignores any construction that completes after the listener has been removed
+            resolution_trace stop()
+            {
+                std::lock_guard lock(m_mutex);
+
+                m_is_stopped = true;
+
+                return resolution_trace(std::move(m_types));
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::vector<type_id> m_types;
+            bool m_is_stopped = false;
+        };
+
+        container& m_container;
+        std::shared_ptr<listener> m_listener;
+        bool m_is_stopped = false;
+    };
+
+    // Constructs the cached instances of the types in trace, in order, on another thread. A type that's resolved before
+    // it's been prefetched is constructed by the thread resolving it, and any other thread resolving it waits for that
+    // instance rather than constructing another. Types that aren't registered, or whose construction throws, are skipped -
+    // they're reported when resolved. The returned future is ready once every type has been visited, and waits for that
+    // when destroyed, so it must be destroyed before the container.
+    inline std::future<void> prefetch(const container& container, resolution_trace trace)
+    {
+        return std::async(std::launch::async, [&container, trace = std::move(trace)]()
+            {
+                for (auto id : trace.types())
+                {
+                    try
+                    {
+                        container.get_factory().prefetch(id);
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+            });
+    }
+}
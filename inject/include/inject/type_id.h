@@ -1,66 +1,156 @@
 #pragma once
 
-#include <functional> // std::hash
+#include <algorithm> // std::min
+#include <cstddef>
+#include <functional> // std::hash, std::less
+#include <string_view>
 
 namespace inject
 {
-    // An alternative to std::type_index that doesn't require RTTI to be enabled
+    // An alternative to std::type_index that doesn't require RTTI to be enabled.
+    // The id is a hash of the type's name, as spelled by the compiler, so it's the same in every module (executable or
+    // shared library) and in every run of the program. A type whose name doesn't identify it, such as a type declared in
+    // an anonymous namespace, a closure type or a local class, is also identified by the address of a variable that's
+    // only shared by the translation units that share the type. Its id isn't portable - it's only equal within the
+    // module that declares the type and is different in every run of the program.
     class type_id
     {
     public:
         template<typename T>
-        static type_id get() noexcept
+        static constexpr type_id get() noexcept
         {
-            return type_id(generate<T>());
+            constexpr std::size_t id = generate<T>(); // Ensure the hash is computed at compile time
+            constexpr bool is_portable = is_portable_name(name<T>());
+
+            if constexpr (is_portable)
+            {
+                return type_id(id, nullptr);
+            }
+            else
+            {
+                return type_id(id, &local_tag<T>);
+            }
+        }
+
+        // The name of T as spelled by the compiler, intended for diagnostics
+        template<typename T>
+        static constexpr std::string_view name() noexcept
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            constexpr std::string_view signature = __FUNCSIG__; // ... type_id::name<T>(void) noexcept
+            constexpr std::string_view prefix = "name<";
+            constexpr std::size_t begin = signature.find(prefix) + prefix.size();
+            constexpr std::size_t end = signature.rfind(">(void)");
+#else
+            // ... type_id::name() [with T = T; ...] or [T = T] - searched from the back as T may contain ']', e.g. int [3]
+            constexpr std::string_view signature = __PRETTY_FUNCTION__;
+            constexpr std::string_view prefix = "T = ";
+            constexpr std::size_t begin = signature.find(prefix) + prefix.size();
+            constexpr std::size_t end = std::min(signature.find(';', begin), signature.rfind(']'));
+#endif
+
+            return signature.substr(begin, end - begin);
+        }
+
+        // True if the id identifies the same type in every module and in every run of the program
+        constexpr bool is_portable() const noexcept
+        {
+            return m_local == nullptr;
         }
 
         const std::size_t id;
 
     private:
-        explicit type_id(std::size_t id) noexcept : id(id)
+        friend class resolution_trace; // Reads ids saved by a previous run
+        friend constexpr bool operator<(type_id lhs, type_id rhs) noexcept;
+        friend constexpr bool operator==(type_id lhs, type_id rhs) noexcept;
+
+        constexpr type_id(std::size_t value, const void* local) noexcept : id(value), m_local(local)
         {
         }
 
+        // Writable so that the linker can't fold the instantiations for different types into one
         template<typename T>
-        static std::size_t generate() noexcept
+        static inline char local_tag = 0;
+
+        // False if the name contains the compiler's spelling of an anonymous namespace, a closure type, an unnamed type or
+        // a local class, for GCC, Clang and MSVC respectively
+        static constexpr bool is_portable_name(std::string_view value) noexcept
         {
-            static const std::size_t id = generate_next();
-            return id;
+            constexpr std::string_view markers[] =
+            {
+                "{anonymous}", "<lambda", "<unnamed", ")::", " const::",
+                "(anonymous", "(lambda", "(unnamed",
+                "anonymous namespace'", "<lambda_", "<unnamed-", "'::"
+            };
+
+            for (auto marker : markers)
+            {
+                if (value.find(marker) != std::string_view::npos)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // The signature of this function includes the name of T
+        template<typename T>
+        static constexpr std::size_t generate() noexcept
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return hash(__FUNCSIG__);
+#else
+            return hash(__PRETTY_FUNCTION__);
+#endif
         }
 
-        static std::size_t generate_next() noexcept
+        // FNV-1a
+        static constexpr std::size_t hash(std::string_view value) noexcept
         {
-            static std::size_t id_next = {};
-            return id_next++;
+            constexpr bool is_64_bit = sizeof(std::size_t) == 8;
+
+            std::size_t result = is_64_bit ? static_cast<std::size_t>(14695981039346656037ull) : 2166136261u;
+
+            for (char ch : value)
+            {
+                result ^= static_cast<unsigned char>(ch);
+                result *= is_64_bit ? static_cast<std::size_t>(1099511628211ull) : 16777619u;
+            }
+
+            return result;
         }
+
+        const void* m_local; // Null if the id is portable
     };
 
-    inline bool operator<(type_id lhs, type_id rhs) noexcept
+    constexpr bool operator<(type_id lhs, type_id rhs) noexcept
     {
-        return lhs.id < rhs.id;
+        return lhs.id != rhs.id ? lhs.id < rhs.id : std::less<const void*>()(lhs.m_local, rhs.m_local);
     }
 
-    inline bool operator>(type_id lhs, type_id rhs) noexcept
+    constexpr bool operator>(type_id lhs, type_id rhs) noexcept
     {
         return rhs < lhs;
     }
 
-    inline bool operator<=(type_id lhs, type_id rhs) noexcept
+    constexpr bool operator<=(type_id lhs, type_id rhs) noexcept
     {
         return !(lhs > rhs);
     }
 
-    inline bool operator>=(type_id lhs, type_id rhs) noexcept
+    constexpr bool operator>=(type_id lhs, type_id rhs) noexcept
     {
         return !(lhs < rhs);
     }
 
-    inline bool operator==(type_id lhs, type_id rhs) noexcept
+    constexpr bool operator==(type_id lhs, type_id rhs) noexcept
     {
-        return lhs.id == rhs.id;
+        return lhs.id == rhs.id && lhs.m_local == rhs.m_local;
     }
 
-    inline bool operator!=(type_id lhs, type_id rhs) noexcept
+    constexpr bool operator!=(type_id lhs, type_id rhs) noexcept
     {
         return !(lhs == rhs);
     }
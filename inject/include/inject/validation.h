@@ -0,0 +1,35 @@
+#pragma once
+
+#include "type_id.h"
+
+#include <string_view>
+#include <vector>
+
+namespace inject
+{
+    // A type resolved by a factory, recorded when the factory is registered
+    struct dependency
+    {
+        type_id id;
+        std::string_view name;
+    };
+
+    // The problems found in the dependency graph of a container. Types provided by a module that hasn't been loaded yet
+    // are treated as registered, but as their dependencies are unknown they can't be validated.
+    struct validation_result
+    {
+        struct missing_dependency
+        {
+            dependency dependent;
+            dependency required;
+        };
+
+        std::vector<missing_dependency> missing;
+        std::vector<std::vector<dependency>> cycles; // Each cycle is listed in resolution order, the last type depends on the first
+
+        bool is_valid() const noexcept
+        {
+            return missing.empty() && cycles.empty();
+        }
+    };
+}
@@ -0,0 +1,236 @@
+#include "instrumentation.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h> // _aligned_malloc
+#endif
+
+#if defined(__GLIBC__)
+#include <dlfcn.h> // dlsym
+#include <pthread.h>
+#endif
+
+namespace
+{
+    std::atomic<std::size_t> g_allocations = 0;
+    std::atomic<std::size_t> g_deallocations = 0;
+    std::atomic<std::size_t> g_exclusive_locks = 0;
+    std::atomic<std::size_t> g_shared_locks = 0;
+    std::atomic<std::size_t> g_lock_waits = 0;
+    std::atomic<std::size_t> g_mutex_locks = 0;
+
+    void* allocate(std::size_t size)
+    {
+        ++g_allocations;
+
+        if (auto ptr = std::malloc(size ? size : 1))
+        {
+            return ptr;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    void* allocate(std::size_t size, std::align_val_t alignment)
+    {
+        ++g_allocations;
+
+        const auto align = static_cast<std::size_t>(alignment);
+        const auto size_aligned = (size + align - 1) / align * align; // std::aligned_alloc requires a multiple of the alignment
+
+#if defined(_WIN32)
+        auto ptr = ::_aligned_malloc(size_aligned ? size_aligned : align, align);
+#else
+        auto ptr = std::aligned_alloc(align, size_aligned ? size_aligned : align);
+#endif
+
+        if (ptr)
+        {
+            return ptr;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    void deallocate(void* ptr) noexcept
+    {
+        if (ptr)
+        {
+            ++g_deallocations;
+            std::free(ptr);
+        }
+    }
+
+    void deallocate(void* ptr, std::align_val_t) noexcept
+    {
+        if (ptr)
+        {
+            ++g_deallocations;
+#if defined(_WIN32)
+            ::_aligned_free(ptr);
+#else
+            std::free(ptr);
+#endif
+        }
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+    deallocate(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    deallocate(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(ptr, alignment);
+}
+
+#if defined(__GLIBC__)
+namespace
+{
+    using pthread_mutex_lock_type = int (*)(pthread_mutex_t*);
+
+    // Resolved on first use - a function local static would itself lock
+    std::atomic<pthread_mutex_lock_type> g_pthread_mutex_lock = nullptr;
+}
+
+// Interposes the C library's pthread_mutex_lock, through which std::mutex and the mutex pool that libstdc++ uses for
+// std::atomic_load on std::shared_ptr are locked
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    auto fn = g_pthread_mutex_lock.load(std::memory_order_acquire);
+
+    if (!fn)
+    {
+        fn = reinterpret_cast<pthread_mutex_lock_type>(::dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        g_pthread_mutex_lock.store(fn, std::memory_order_release);
+    }
+
+    ++g_mutex_locks;
+
+    return fn(mutex);
+}
+#endif
+
+namespace inject_perf
+{
+    counters get_counters() noexcept
+    {
+        return { g_allocations, g_deallocations, g_exclusive_locks, g_shared_locks, g_lock_waits, g_mutex_locks };
+    }
+
+    bool is_counting_mutex_locks() noexcept
+    {
+#if defined(__GLIBC__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void counting_shared_mutex::lock()
+    {
+        if (!m_mutex.try_lock())
+        {
+            ++g_lock_waits;
+            m_mutex.lock();
+        }
+
+        ++g_exclusive_locks;
+    }
+
+    bool counting_shared_mutex::try_lock()
+    {
+        if (m_mutex.try_lock())
+        {
+            ++g_exclusive_locks;
+            return true;
+        }
+
+        return false;
+    }
+
+    void counting_shared_mutex::unlock()
+    {
+        m_mutex.unlock();
+    }
+
+    void counting_shared_mutex::lock_shared()
+    {
+        if (!m_mutex.try_lock_shared())
+        {
+            ++g_lock_waits;
+            m_mutex.lock_shared();
+        }
+
+        ++g_shared_locks;
+    }
+
+    bool counting_shared_mutex::try_lock_shared()
+    {
+        if (m_mutex.try_lock_shared())
+        {
+            ++g_shared_locks;
+            return true;
+        }
+
+        return false;
+    }
+
+    void counting_shared_mutex::unlock_shared()
+    {
+        m_mutex.unlock_shared();
+    }
+}
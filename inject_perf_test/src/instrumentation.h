@@ -0,0 +1,70 @@
+#pragma once
+
+// The build sets INJECT_SHARED_MUTEX to counting_shared_mutex for every translation unit of the test, so that the
+// registry locks through it. As registry.h names the type, this header must be included before any inject header.
+
+#include <atomic>
+#include <cstddef>
+#include <shared_mutex>
+
+namespace inject_perf
+{
+    // Global operator new/delete and lock counts for the whole process
+    struct counters
+    {
+        std::size_t allocations;
+        std::size_t deallocations;
+        std::size_t exclusive_locks; // Registry locks, through counting_shared_mutex
+        std::size_t shared_locks;
+        std::size_t lock_waits; // Registry lock acquisitions that couldn't be satisfied immediately
+        std::size_t mutex_locks; // Any other mutex, including the pool behind std::atomic_load for std::shared_ptr - glibc only
+    };
+
+    // Whether mutex_locks is counted on this platform
+    bool is_counting_mutex_locks() noexcept;
+
+    counters get_counters() noexcept;
+
+    // Counts the allocations and lock acquisitions made from construction until get is called
+    class measure
+    {
+    public:
+        measure() noexcept : m_begin(get_counters())
+        {
+        }
+
+        counters get() const noexcept
+        {
+            auto end = get_counters();
+
+            return
+            {
+                end.allocations - m_begin.allocations,
+                end.deallocations - m_begin.deallocations,
+                end.exclusive_locks - m_begin.exclusive_locks,
+                end.shared_locks - m_begin.shared_locks,
+                end.lock_waits - m_begin.lock_waits,
+                end.mutex_locks - m_begin.mutex_locks
+            };
+        }
+
+    private:
+        counters m_begin;
+    };
+
+    // std::shared_mutex that counts acquisitions and waits
+    class counting_shared_mutex
+    {
+    public:
+        void lock();
+        bool try_lock();
+        void unlock();
+
+        void lock_shared();
+        bool try_lock_shared();
+        void unlock_shared();
+
+    private:
+        std::shared_mutex m_mutex;
+    };
+}
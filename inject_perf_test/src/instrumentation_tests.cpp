@@ -0,0 +1,52 @@
+#include "instrumentation.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+TEST(instrumentation, mutex_lock_counted)
+{
+    if (!inject_perf::is_counting_mutex_locks())
+    {
+        GTEST_SKIP();
+    }
+
+    // Arrange
+    std::mutex mutex;
+
+    inject_perf::measure measure;
+
+    // Action
+    mutex.lock();
+    mutex.unlock();
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(1u, counters.mutex_locks);
+}
+
+TEST(instrumentation, atomic_load_shared_ptr_counted)
+{
+    // Arrange
+    auto value = std::make_shared<int>(1);
+
+    if (!inject_perf::is_counting_mutex_locks() || std::atomic_is_lock_free(&value))
+    {
+        GTEST_SKIP();
+    }
+
+    inject_perf::measure measure;
+
+    // Action
+    auto result = std::atomic_load(&value);
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(1, *result);
+    ASSERT_EQ(1u, counters.mutex_locks);
+}
@@ -0,0 +1,196 @@
+// Measures how the throughput of concurrent lookups scales with the number of threads, for the lock free registry and for
+// a baseline that guards a std::unordered_map with a std::shared_mutex, as the registry did before lookups were lock
+// free. Timings depend on the machine so this isn't run by ctest - CI runs it in a Release build on a runner with
+// several cores, passing --min-speedup=<ratio> to fail if, at the highest thread count, the registry's throughput is
+// less than ratio times the baseline's. The ratio defaults to 1, and isn't checked when only one thread is available.
+
+#include "inject/container.h"
+#include "inject/registry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct service
+    {
+        int value;
+    };
+
+    // The registry's previous design - every lookup acquires the shared lock, so every reader writes to the mutex
+    class locked_registry
+    {
+    public:
+        void emplace(inject::type_id id, int value)
+        {
+            std::unique_lock lock(m_mutex);
+            m_values.emplace(id, value);
+        }
+
+        const int* find(inject::type_id id) const
+        {
+            std::shared_lock lock(m_mutex);
+
+            auto it = m_values.find(id);
+            return it != m_values.end() ? &it->second : nullptr;
+        }
+
+    private:
+        mutable std::shared_mutex m_mutex;
+        std::unordered_map<inject::type_id, int> m_values;
+    };
+
+    // Registers 64 types, as a lookup is only representative if the table isn't trivially small
+    template<typename Registry, std::size_t... Is>
+    void emplace_types(Registry& registry, std::index_sequence<Is...>)
+    {
+        (registry.emplace(inject::type_id::get<std::integral_constant<std::size_t, Is>>(), static_cast<int>(Is)), ...);
+    }
+
+    // Returns the number of operations per second performed by thread_count threads each calling fn
+    double measure(std::size_t thread_count, std::size_t iterations, const std::function<void()>& fn)
+    {
+        std::atomic<bool> start = false;
+        std::vector<std::thread> threads;
+
+        for (std::size_t t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&]()
+                {
+                    while (!start)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    for (std::size_t i = 0; i < iterations; ++i)
+                    {
+                        fn();
+                    }
+                });
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        start = true;
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        return static_cast<double>(thread_count * iterations) / elapsed.count();
+    }
+
+    // Prints the throughput at each thread count and returns the throughput at the highest
+    double run(const char* name, std::size_t max_threads, std::size_t iterations, const std::function<void()>& fn)
+    {
+        std::printf("%s\n", name);
+
+        double single = 0;
+        double result = 0;
+
+        for (std::size_t thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+        {
+            result = 0;
+
+            for (int run = 0; run < 3; ++run) // Take the best of several runs to reduce scheduling noise
+            {
+                result = std::max(result, measure(thread_count, iterations, fn));
+            }
+
+            single = thread_count == 1 ? result : single;
+
+            std::printf("  %3zu threads: %12.0f ops/s, efficiency %.2f\n", thread_count, result, result / (single * static_cast<double>(thread_count)));
+        }
+
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    constexpr std::size_t iterations = 1000000;
+
+    double min_speedup = 1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--min-speedup=", 14) == 0)
+        {
+            min_speedup = std::atof(argv[i] + 14);
+        }
+    }
+
+    std::size_t max_threads = 1;
+
+    while (max_threads * 2 <= std::thread::hardware_concurrency())
+    {
+        max_threads *= 2; // The highest thread count run is a power of two
+    }
+
+    // Every thread looks up the same type, the case in which readers of a shared lock contend the most
+    const auto id = inject::type_id::get<std::integral_constant<std::size_t, 0>>();
+
+    inject::registry<int> registry;
+    locked_registry baseline;
+
+    emplace_types(registry, std::make_index_sequence<64>());
+    emplace_types(baseline, std::make_index_sequence<64>());
+
+    auto throughput_baseline = run("std::shared_mutex + std::unordered_map find (baseline)", max_threads, iterations, [&]()
+        {
+            volatile auto result = baseline.find(id);
+            (void)result;
+        });
+
+    auto throughput_registry = run("inject::registry find", max_threads, iterations, [&]()
+        {
+            volatile auto result = registry.find(id);
+            (void)result;
+        });
+
+    // The registry lookups above in the context of a resolve
+    inject::container container;
+
+    container.register_shared<service>([]() { return std::make_shared<service>(service{ 1 }); });
+    container.register_cached<int>([]() { return 1; });
+
+    run("resolve<int> cached", max_threads, iterations, [&]()
+        {
+            volatile int result = container.resolve<int>();
+            (void)result;
+        });
+
+    // Copying a std::shared_ptr increments the shared reference count, which limits scaling regardless of the registry
+    run("resolve_shared<service>", max_threads, iterations, [&]()
+        {
+            auto result = container.resolve_shared<service>();
+            (void)result;
+        });
+
+    const double speedup = throughput_registry / throughput_baseline;
+
+    std::printf("Speedup over the baseline at %zu threads: %.2f\n", max_threads, speedup);
+
+    if (max_threads > 1 && speedup < min_speedup)
+    {
+        std::printf("FAILED: the speedup is below %.2f\n", min_speedup);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,247 @@
+#include "instrumentation.h"
+
+#include "inject/container.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct type_a
+    {
+        int value;
+    };
+
+    struct type_b
+    {
+        int value;
+    };
+
+    struct type_c
+    {
+        int value;
+    };
+
+    // type_a depends on type_b and type_c, each resolved as a new std::unique_ptr
+    void register_unique_graph(inject::container& container)
+    {
+        container.register_unique<type_a>([](std::unique_ptr<type_b> b, std::unique_ptr<type_c> c)
+            {
+                return std::make_unique<type_a>(type_a{ b->value + c->value });
+            });
+
+        container.register_unique<type_b>([]()
+            {
+                return std::make_unique<type_b>(type_b{ 1 });
+            });
+
+        container.register_unique<type_c>([]()
+            {
+                return std::make_unique<type_c>(type_c{ 2 });
+            });
+    }
+}
+
+TEST(resolve, register_type_locks_exclusive)
+{
+    // Arrange
+    inject::container container;
+
+    inject_perf::measure measure;
+
+    // Action
+    container.register_type<int>([]() { return 1; });
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(1u, counters.exclusive_locks);
+    ASSERT_GT(counters.allocations, 0u);
+}
+
+TEST(resolve, resolve_shared_cached_no_allocations)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_shared<int>([]() { return std::make_shared<int>(1); });
+    container.resolve_shared<int>(); // Create the cached instance
+
+    inject_perf::measure measure;
+
+    // Action
+    auto result = container.resolve_shared<int>();
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(1, *result);
+    ASSERT_EQ(0u, counters.allocations);
+    ASSERT_EQ(0u, counters.exclusive_locks);
+    ASSERT_EQ(0u, counters.shared_locks); // Registered factories are looked up without locking
+    ASSERT_EQ(0u, counters.mutex_locks); // The cached std::shared_ptr is copied without locking
+}
+
+TEST(resolve, resolve_cached_no_allocations)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_cached<int>([]() { return 1; });
+    container.resolve<int>(); // Create the cached instance
+
+    inject_perf::measure measure;
+
+    // Action
+    auto result = container.resolve<int>();
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(1, result);
+    ASSERT_EQ(0u, counters.allocations);
+    ASSERT_EQ(0u, counters.exclusive_locks);
+    ASSERT_EQ(0u, counters.mutex_locks);
+}
+
+TEST(resolve, resolve_unique_allocates_instances_only)
+{
+    // Arrange
+    inject::container container;
+
+    register_unique_graph(container);
+
+    inject_perf::measure measure;
+
+    // Action
+    auto result = container.resolve_unique<type_a>();
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(3, result->value);
+    ASSERT_EQ(3u, counters.allocations); // type_a, type_b and type_c
+    ASSERT_EQ(2u, counters.deallocations); // type_b and type_c
+    ASSERT_EQ(0u, counters.exclusive_locks);
+    ASSERT_EQ(0u, counters.shared_locks);
+    ASSERT_EQ(0u, counters.mutex_locks);
+}
+
+TEST(resolve, resolve_unique_validated_allocates_instances_only)
+{
+    // Arrange
+    inject::container container;
+
+    register_unique_graph(container);
+
+    ASSERT_TRUE(container.validate().is_valid());
+
+    inject_perf::measure measure;
+
+    // Action
+    auto result = container.resolve_unique<type_a>();
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(3, result->value);
+    ASSERT_EQ(3u, counters.allocations);
+    ASSERT_EQ(0u, counters.exclusive_locks);
+    ASSERT_EQ(0u, counters.shared_locks);
+    ASSERT_EQ(0u, counters.mutex_locks);
+}
+
+TEST(resolve, resolve_runtime_args_no_allocations)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_type<int(int)>([](std::shared_ptr<int> shared, int value) { return *shared + value; });
+    container.register_shared<int>([]() { return std::make_shared<int>(1); });
+    container.resolve<int(int)>(0); // Create the cached instance
+
+    inject_perf::measure measure;
+
+    // Action
+    auto result = container.resolve<int(int)>(2);
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(3, result);
+    ASSERT_EQ(0u, counters.allocations);
+    ASSERT_EQ(0u, counters.exclusive_locks);
+    ASSERT_EQ(0u, counters.mutex_locks);
+}
+
+TEST(resolve, resolve_decorated_no_allocations)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_type<int>([]() { return 1; });
+    container.register_cached<float>([]() { return 2.0f; });
+    container.decorate<int>([](int value) { return value + 1; }, [](int value, float f) { return value + static_cast<int>(f); });
+
+    ASSERT_TRUE(container.validate().is_valid());
+
+    inject_perf::measure measure;
+
+    // Action
+    auto result = container.resolve<int>();
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(4, result);
+    ASSERT_EQ(0u, counters.allocations);
+    ASSERT_EQ(0u, counters.exclusive_locks);
+    ASSERT_EQ(0u, counters.shared_locks);
+    ASSERT_EQ(0u, counters.mutex_locks);
+}
+
+TEST(resolve, resolve_concurrent_no_locks)
+{
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t iterations = 10000;
+
+    // Arrange
+    inject::container container;
+
+    register_unique_graph(container);
+    container.register_shared<int>([]() { return std::make_shared<int>(1); });
+    container.resolve_shared<int>(); // Create the cached instance
+
+    inject_perf::measure measure;
+
+    // Action
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([&]()
+            {
+                for (std::size_t i = 0; i < iterations; ++i)
+                {
+                    container.resolve_shared<int>();
+                    container.resolve_unique<type_a>();
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Assert
+    auto counters = measure.get();
+
+    ASSERT_EQ(0u, counters.exclusive_locks);
+    ASSERT_EQ(0u, counters.shared_locks);
+    ASSERT_EQ(0u, counters.lock_waits);
+    ASSERT_EQ(0u, counters.mutex_locks);
+}
@@ -0,0 +1,34 @@
+#include "test_plugin.h"
+
+#include "inject/module.h"
+
+#include <memory>
+#include <utility>
+
+namespace
+{
+    class test_plugin_service : public itest_plugin_service
+    {
+    public:
+        explicit test_plugin_service(std::shared_ptr<test_plugin_config> config) : m_config(std::move(config))
+        {
+        }
+
+        int value() const override
+        {
+            return m_config->value + 1;
+        }
+
+    private:
+        std::shared_ptr<test_plugin_config> m_config;
+    };
+}
+
+INJECT_MODULE_EXPORT void inject_register_module(inject::container& container)
+{
+    // test_plugin_config is registered by the executable loading the module
+    container.register_shared<itest_plugin_service>([](std::shared_ptr<test_plugin_config> config)
+        {
+            return std::make_shared<test_plugin_service>(std::move(config));
+        });
+}
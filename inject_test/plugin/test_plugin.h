@@ -0,0 +1,14 @@
+#pragma once
+
+// Types shared between inject_test and the test plugin module
+
+struct test_plugin_config
+{
+    int value;
+};
+
+struct itest_plugin_service
+{
+    virtual ~itest_plugin_service() = default;
+    virtual int value() const = 0;
+};
@@ -3,6 +3,28 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    struct sized_type
+    {
+        std::string value;
+    };
+
+    struct incomplete_type;
+}
+
+template<>
+struct inject::memory_size<sized_type>
+{
+    std::size_t operator()(const sized_type& value) const noexcept
+    {
+        return sizeof(value) + value.value.capacity();
+    }
+};
+
 TEST(container, register_shared_succeeds)
 {
     // Arrange
@@ -95,6 +117,23 @@ TEST(container, register_unique_interface_succeeds)
     ASSERT_TRUE(container.is_registered_unique<itype>());
 }
 
+TEST(container, register_lazy_move_only_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    auto value = std::make_unique<int>(1);
+
+    // Action
+    container.register_lazy<int>([value = std::move(value)](inject::container& target)
+        {
+            target.register_cached<int>([value = *value]() { return value; });
+        });
+
+    // Assert
+    ASSERT_EQ(1, container.resolve<int>());
+}
+
 TEST(container, resolve_cached_succeeds)
 {
     // Arrange
@@ -112,6 +151,23 @@ TEST(container, resolve_cached_succeeds)
     ASSERT_EQ(1, result);
 }
 
+TEST(container, resolve_cached_move_only_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_cached<int>([value = std::make_unique<int>(1)]()
+        {
+            return *value;
+        });
+
+    // Action
+    auto result = container.resolve<int>();
+
+    // Assert
+    ASSERT_EQ(1, result);
+}
+
 TEST(container, resolve_shared_succeeds)
 {
     // Arrange
@@ -284,3 +340,260 @@ TEST(container, resolve_unique_args_succeeds)
     ASSERT_EQ("Char: a, Float: 3.142", *result1);
     ASSERT_EQ("Char: a, Float: 3.142", *result2);
 }
+
+TEST(container, resolve_unique_runtime_args_succeeds)
+{
+    struct type
+    {
+        std::shared_ptr<int> shared;
+        int value;
+    };
+
+    // Arrange
+    inject::container container;
+
+    container.register_shared<int>([]()
+        {
+            return std::make_shared<int>(1);
+        });
+
+    container.register_type<std::unique_ptr<type>(int)>([](std::shared_ptr<int> shared, int value)
+        {
+            return std::make_unique<type>(type{ std::move(shared), value });
+        });
+
+    // Action
+    auto result1 = container.resolve<std::unique_ptr<type>(int)>(2);
+    auto result2 = container.resolve<std::unique_ptr<type>(int)>(3);
+
+    // Assert
+    const bool is_same = result1->shared.get() == result2->shared.get();
+
+    ASSERT_TRUE(is_same);
+    ASSERT_EQ(2, result1->value);
+    ASSERT_EQ(3, result2->value);
+}
+
+TEST(container, resolve_noexcept_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    auto fn = []() noexcept
+    {
+        return 1;
+    };
+
+    auto fn_args = [](int i) noexcept
+    {
+        return i;
+    };
+
+    // Action
+    auto result = container.resolve(fn);
+
+    // Assert
+    constexpr bool is_noexcept = noexcept(container.resolve(fn));
+    constexpr bool is_noexcept_args = noexcept(container.resolve(fn_args, 1));
+
+    ASSERT_TRUE(is_noexcept);
+    ASSERT_FALSE(is_noexcept_args);
+    ASSERT_EQ(1, result);
+}
+
+TEST(container, decorate_shared_succeeds)
+{
+    struct type_a
+    {
+        int value;
+    };
+
+    // Arrange
+    inject::container container;
+
+    int count = 0;
+
+    container.register_shared<type_a>([]() { return std::make_shared<type_a>(type_a{ 1 }); });
+
+    // Action
+    container.decorate_shared<type_a>([&](std::shared_ptr<type_a> value)
+        {
+            ++count;
+            return std::make_shared<type_a>(type_a{ value->value + 1 });
+        });
+
+    auto result1 = container.resolve_shared<type_a>();
+    auto result2 = container.resolve_shared<type_a>();
+
+    // Assert
+    ASSERT_EQ(2, result1->value);
+    ASSERT_EQ(result1, result2);
+    ASSERT_EQ(1, count); // The cached instance is only decorated once
+}
+
+TEST(container, decorate_cached_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    int count = 0;
+
+    container.register_cached<int>([]() { return 1; });
+
+    // Action
+    container.decorate<int>([&](int value)
+        {
+            ++count;
+            return value * 2;
+        });
+
+    auto result1 = container.resolve<int>();
+    auto result2 = container.resolve<int>();
+
+    // Assert
+    ASSERT_EQ(2, result1);
+    ASSERT_EQ(2, result2);
+    ASSERT_EQ(1, count);
+}
+
+TEST(container, decorate_unique_succeeds)
+{
+    struct type_a
+    {
+        virtual ~type_a() = default;
+        virtual int get() const { return 1; }
+    };
+
+    struct type_b : type_a
+    {
+        type_b(std::unique_ptr<type_a> inner, std::shared_ptr<int> offset) : m_inner(std::move(inner)), m_offset(std::move(offset)) {}
+        int get() const override { return m_inner->get() + *m_offset; }
+
+        std::unique_ptr<type_a> m_inner;
+        std::shared_ptr<int> m_offset;
+    };
+
+    // Arrange
+    inject::container container;
+
+    container.register_unique<type_a>([]() { return std::make_unique<type_a>(); });
+    container.register_shared<int>([]() { return std::make_shared<int>(10); });
+
+    // Action
+    container.decorate_unique<type_a>([](std::unique_ptr<type_a> inner, std::shared_ptr<int> offset) -> std::unique_ptr<type_a>
+        {
+            return std::make_unique<type_b>(std::move(inner), std::move(offset));
+        });
+
+    auto result1 = container.resolve_unique<type_a>();
+    auto result2 = container.resolve_unique<type_a>();
+
+    // Assert
+    ASSERT_EQ(11, result1->get());
+    ASSERT_NE(result1, result2);
+}
+
+TEST(container, validate_cached_cycle)
+{
+    struct type_a
+    {
+    };
+
+    struct type_b
+    {
+    };
+
+    // Arrange
+    inject::container container;
+
+    container.register_shared<type_a>([](std::shared_ptr<type_b>) { return std::shared_ptr<type_a>(); });
+    container.register_shared<type_b>([](std::shared_ptr<type_a>) { return std::shared_ptr<type_b>(); });
+    container.register_unique<int>([](std::shared_ptr<type_a>) { return std::make_unique<int>(1); });
+
+    // Action
+    auto result = container.validate();
+
+    // Assert
+    ASSERT_FALSE(result.is_valid());
+    ASSERT_TRUE(result.missing.empty());
+    ASSERT_EQ(1u, result.cycles.size());
+    ASSERT_EQ(2u, result.cycles[0].size());
+}
+
+TEST(container, validate_module_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_lazy<std::shared_ptr<float>>([](inject::container&) {});
+    container.register_unique<int>([](std::shared_ptr<float>) { return std::make_unique<int>(1); });
+
+    // Action
+    auto result = container.validate();
+
+    // Assert
+    ASSERT_TRUE(result.is_valid());
+}
+
+TEST(container, memory_stats_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_cached<int>([]() { return 1; });
+    container.register_shared<sized_type>([]() { return std::make_shared<sized_type>(sized_type{ std::string(100, 'a') }); });
+    container.register_unique<int>([]() { return std::make_unique<int>(1); });
+
+    auto instance = container.resolve_shared<sized_type>();
+
+    // Action
+    auto result = container.memory_stats();
+
+    // Assert
+    auto find_registration = [&](inject::type_id id)
+    {
+        return *std::find_if(result.registrations.begin(), result.registrations.end(), [&](const auto& registration) { return registration.id == id; });
+    };
+
+    auto registration_cached = find_registration(inject::type_id::get<int>());
+    auto registration_shared = find_registration(inject::type_id::get<std::shared_ptr<sized_type>>());
+    auto registration_unique = find_registration(inject::type_id::get<std::unique_ptr<int>>());
+
+    ASSERT_EQ(3u, result.registrations.size());
+    ASSERT_GT(result.registry_bytes, 0u);
+    ASSERT_GT(result.invoker_bytes, 0u);
+    ASSERT_EQ(1u, result.cached_instances);
+
+    ASSERT_TRUE(registration_cached.is_cached);
+    ASSERT_FALSE(registration_cached.is_constructed);
+    ASSERT_EQ(0u, registration_cached.cached_bytes);
+
+    ASSERT_TRUE(registration_shared.is_cached);
+    ASSERT_TRUE(registration_shared.is_constructed);
+    ASSERT_EQ(inject::memory_size<sized_type>()(*instance), registration_shared.cached_bytes); // The std::shared_ptr itself is counted in invoker_bytes
+    ASSERT_EQ(registration_shared.cached_bytes, result.cached_bytes);
+
+    ASSERT_FALSE(registration_unique.is_cached);
+    ASSERT_FALSE(registration_unique.is_constructed);
+    ASSERT_EQ(0u, registration_unique.cached_bytes);
+}
+
+TEST(container, memory_stats_incomplete_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_shared<incomplete_type>([]() { return std::shared_ptr<incomplete_type>(); });
+
+    container.resolve_shared<incomplete_type>();
+
+    // Action
+    auto result = container.memory_stats();
+
+    // Assert
+    ASSERT_EQ(1u, result.registrations.size());
+    ASSERT_GE(result.registrations[0].invoker_bytes, sizeof(std::shared_ptr<incomplete_type>));
+    ASSERT_TRUE(result.registrations[0].is_constructed);
+    ASSERT_EQ(0u, result.registrations[0].cached_bytes);
+    ASSERT_EQ(1u, result.cached_instances);
+}
@@ -49,6 +49,24 @@ TEST(factory, register_type_duplicate_throws)
     ASSERT_THROW(factory.register_type<int>(fn), inject::factory_exception);
 }
 
+TEST(factory, register_type_move_only_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    auto fn = [value = std::make_unique<int>(1)]()
+    {
+        return *value;
+    };
+
+    // Action
+    factory.register_type<int>(std::move(fn));
+
+    // Assert
+    ASSERT_TRUE(factory.is_registered<int>());
+    ASSERT_EQ(1, factory.resolve<int>());
+}
+
 TEST(factory, resolve_succeeds)
 {
     // Arrange
@@ -179,3 +197,407 @@ TEST(factory, resolve_nested_succeeds)
     // Assert
     ASSERT_EQ(3, result.value);
 }
+
+TEST(factory, register_type_type_fn_member_succeeds)
+{
+    struct functor
+    {
+        using type_fn = int; // Only callables derived from inject::factory_wrapper are unwrapped
+
+        int operator()() const
+        {
+            return 1;
+        }
+    };
+
+    // Arrange
+    inject::factory factory;
+
+    // Action
+    factory.register_type<int>(functor());
+
+    // Assert
+    ASSERT_EQ(1, factory.resolve<int>());
+}
+
+TEST(factory, resolve_noexcept_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    auto fn = []() noexcept
+    {
+        return 1;
+    };
+
+    auto fn_args = [](int i) noexcept
+    {
+        return i;
+    };
+
+    factory.register_type<int>(fn);
+
+    // Action
+    auto result = factory.resolve<int>();
+
+    // Assert
+    constexpr bool is_noexcept = noexcept(factory.resolve(fn));
+    constexpr bool is_noexcept_args = noexcept(factory.resolve(fn_args));
+    constexpr bool is_noexcept_registered = noexcept(factory.resolve<int>());
+
+    ASSERT_TRUE(is_noexcept);
+    ASSERT_FALSE(is_noexcept_args);
+    ASSERT_FALSE(is_noexcept_registered); // The type may not be registered
+    ASSERT_EQ(1, result);
+}
+
+TEST(factory, register_type_runtime_args_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    // Action
+    factory.register_type<std::string(int)>([](char ch, int count) { return std::string(count, ch); });
+
+    // Assert
+    ASSERT_TRUE(factory.is_registered<std::string(int)>());
+    ASSERT_FALSE(factory.is_registered<std::string>());
+}
+
+TEST(factory, resolve_runtime_args_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_type<std::string(int, std::string)>([](char ch, float f, int i, std::string s)
+        {
+            std::stringstream ss;
+            ss << "Char: " << ch << ", ";
+            ss << "Float: " << f << ", ";
+            ss << "Int: " << i << ", ";
+            ss << "String: " << s;
+            return ss.str();
+        });
+
+    factory.register_type<char>([]()
+        {
+            return 'a';
+        });
+
+    factory.register_type<float>([]()
+        {
+            return 3.142f;
+        });
+
+    // Action
+    auto result = factory.resolve<std::string(int, std::string)>(1, "b");
+
+    // Assert
+    constexpr bool is_expected_type = std::is_same_v<decltype(result), std::string>;
+
+    ASSERT_TRUE(is_expected_type);
+    ASSERT_EQ("Char: a, Float: 3.142, Int: 1, String: b", result);
+}
+
+TEST(factory, resolve_fn_runtime_args_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_type<char>([]()
+        {
+            return 'a';
+        });
+
+    // Action
+    auto result = factory.resolve([](char ch, std::unique_ptr<int> count) { return std::string(*count, ch); }, std::make_unique<int>(3));
+
+    // Assert
+    ASSERT_EQ("aaa", result);
+}
+
+TEST(factory, register_lazy_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    // Action
+    factory.register_lazy<int, float>([]() {});
+
+    // Assert
+    ASSERT_TRUE(factory.is_registered<int>());
+    ASSERT_TRUE(factory.is_registered<float>());
+}
+
+TEST(factory, register_lazy_duplicate_throws)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_lazy<int>([]() {});
+
+    // Action / Assert
+    ASSERT_THROW((factory.register_lazy<float, int>([]() {})), inject::factory_exception);
+    ASSERT_FALSE(factory.is_registered<float>()); // None of the types are registered if any is a duplicate
+}
+
+TEST(factory, register_lazy_move_only_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    auto value = std::make_unique<int>(1);
+
+    // Action
+    factory.register_lazy<int>([&factory, value = std::move(value)]()
+        {
+            factory.register_type<int>([value = *value]() { return value; });
+        });
+
+    // Assert
+    ASSERT_EQ(1, factory.resolve<int>());
+}
+
+TEST(factory, resolve_lazy_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    auto count = std::make_shared<int>(0);
+
+    factory.register_lazy<int, float>([&factory, count]()
+        {
+            ++*count;
+            factory.register_type<int>([]() { return 1; });
+            factory.register_type<float>([]() { return 3.142f; });
+        });
+
+    // Action
+    auto result1 = factory.resolve<float>();
+    auto result2 = factory.resolve<int>();
+
+    // Assert
+    ASSERT_EQ(1, *count);
+    ASSERT_EQ(3.142f, result1);
+    ASSERT_EQ(1, result2);
+}
+
+TEST(factory, resolve_lazy_not_registered)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_lazy<int>([]() {});
+
+    // Action
+    ASSERT_THROW(factory.resolve<int>(), inject::factory_exception);
+}
+
+TEST(factory, validate_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_type<std::string>([](char ch, float f)
+        {
+            std::stringstream ss;
+            ss << "Char: " << ch << ", ";
+            ss << "Float: " << f;
+            return ss.str();
+        });
+
+    factory.register_type<char>([]()
+        {
+            return 'a';
+        });
+
+    factory.register_type<float>([]()
+        {
+            return 3.142f;
+        });
+
+    // Action
+    auto result = factory.validate();
+
+    // Assert
+    ASSERT_TRUE(result.is_valid());
+    ASSERT_EQ("Char: a, Float: 3.142", factory.resolve<std::string>()); // Resolved through the links created by validate
+}
+
+TEST(factory, validate_missing)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_type<std::string(int)>([](char ch, int count)
+        {
+            return std::string(count, ch);
+        });
+
+    // Action
+    auto result = factory.validate();
+
+    // Assert
+    ASSERT_FALSE(result.is_valid());
+    ASSERT_EQ(1u, result.missing.size());
+    ASSERT_TRUE(result.cycles.empty());
+
+    ASSERT_TRUE(result.missing[0].dependent.id == inject::type_id::get<std::string(int)>());
+    ASSERT_TRUE(result.missing[0].required.id == inject::type_id::get<char>());
+    ASSERT_EQ("char", result.missing[0].required.name);
+}
+
+TEST(factory, validate_cycle)
+{
+    struct type_a
+    {
+        int value;
+    };
+
+    struct type_b
+    {
+        int value;
+    };
+
+    struct type_c
+    {
+        int value;
+    };
+
+    // Arrange
+    inject::factory factory;
+
+    factory.register_type<type_a>([](type_b b) -> type_a
+        {
+            return { b.value + 1 };
+        });
+
+    factory.register_type<type_b>([](type_c c) -> type_b
+        {
+            return { c.value + 1 };
+        });
+
+    factory.register_type<type_c>([](type_a a) -> type_c
+        {
+            return { a.value + 1 };
+        });
+
+    // Action
+    auto result = factory.validate();
+
+    // Assert
+    ASSERT_FALSE(result.is_valid());
+    ASSERT_TRUE(result.missing.empty());
+    ASSERT_EQ(1u, result.cycles.size());
+    ASSERT_EQ(3u, result.cycles[0].size());
+}
+
+TEST(factory, decorate_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_type<std::string>([]()
+        {
+            return std::string("a");
+        });
+
+    factory.register_type<char>([]()
+        {
+            return 'c';
+        });
+
+    // Action
+    factory.decorate<std::string>([](std::string value)
+        {
+            return value + "b";
+        },
+        [](std::string value, char ch)
+        {
+            return value + ch;
+        });
+
+    // Assert
+    ASSERT_EQ("abc", factory.resolve<std::string>());
+    ASSERT_EQ("abc", factory.resolve<std::string>());
+}
+
+TEST(factory, decorate_lazy_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_lazy<std::string>([&factory]()
+        {
+            factory.register_type<std::string>([]() { return std::string("a"); });
+        });
+
+    // Action
+    factory.decorate<std::string>([](std::string value) { return value + "b"; });
+
+    // Assert
+    ASSERT_EQ("ab", factory.resolve<std::string>());
+}
+
+TEST(factory, decorate_repeat_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_type<std::string>([]()
+        {
+            return std::string("a");
+        });
+
+    // Action
+    factory.decorate<std::string>([](std::string value) { return value + "b"; });
+    factory.decorate<std::string>([](std::string value) { return value + "c"; });
+
+    // Assert
+    ASSERT_EQ("abc", factory.resolve<std::string>());
+}
+
+TEST(factory, decorate_not_registered_throws)
+{
+    // Arrange
+    inject::factory factory;
+
+    // Action / Assert
+    ASSERT_THROW(factory.decorate<int>([](int value) { return value; }), inject::factory_exception);
+}
+
+TEST(factory, decorate_validate_succeeds)
+{
+    // Arrange
+    inject::factory factory;
+
+    factory.register_type<std::string>([](char ch)
+        {
+            return std::string(1, ch);
+        });
+
+    factory.register_type<char>([]()
+        {
+            return 'a';
+        });
+
+    ASSERT_TRUE(factory.validate().is_valid()); // Links std::string to char before char is decorated
+
+    // Action
+    factory.decorate<char>([](char ch) { return static_cast<char>(ch + 1); });
+    factory.decorate<std::string>([](std::string value, float f) { return value + std::to_string(static_cast<int>(f)); });
+
+    auto missing = factory.validate();
+
+    factory.register_type<float>([]() { return 3.0f; });
+
+    auto result = factory.validate();
+
+    // Assert
+    ASSERT_FALSE(missing.is_valid());
+    ASSERT_EQ(1u, missing.missing.size());
+    ASSERT_TRUE(missing.missing[0].required.id == inject::type_id::get<float>());
+
+    ASSERT_TRUE(result.is_valid());
+    ASSERT_EQ("b3", factory.resolve<std::string>()); // The decorated char is resolved rather than the linked factory it replaced
+}
@@ -0,0 +1,78 @@
+#include "inject/module.h"
+
+#include "test_plugin.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <string>
+
+TEST(module, register_module_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    // Action
+    inject::register_module<std::shared_ptr<itest_plugin_service>>(container, INJECT_TEST_PLUGIN_PATH);
+
+    // Assert
+    ASSERT_TRUE(container.is_registered_shared<itest_plugin_service>());
+}
+
+TEST(module, resolve_module_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_shared<test_plugin_config>([]()
+        {
+            return std::make_shared<test_plugin_config>(test_plugin_config{ 1 });
+        });
+
+    inject::register_module<std::shared_ptr<itest_plugin_service>>(container, INJECT_TEST_PLUGIN_PATH);
+
+    // Action
+    auto result1 = container.resolve_shared<itest_plugin_service>();
+    auto result2 = container.resolve_shared<itest_plugin_service>();
+
+    // Assert
+    const bool is_same = result1.get() == result2.get();
+
+    ASSERT_TRUE(is_same);
+    ASSERT_EQ(2, result1->value());
+}
+
+TEST(module, resolve_module_not_found_throws)
+{
+    // Arrange
+    inject::container container;
+
+    inject::register_module<std::shared_ptr<itest_plugin_service>>(container, "inject_test_plugin_not_found");
+
+    // Action
+    ASSERT_THROW(container.resolve_shared<itest_plugin_service>(), inject::factory_exception);
+}
+
+TEST(module, resolve_module_not_found_message)
+{
+    // Arrange
+    inject::container container;
+
+    inject::register_module<std::shared_ptr<itest_plugin_service>>(container, "inject_test_plugin_not_found");
+
+    // Action
+    std::string result;
+
+    try
+    {
+        container.resolve_shared<itest_plugin_service>();
+    }
+    catch (const inject::factory_exception& e)
+    {
+        result = e.what();
+    }
+
+    // Assert
+    ASSERT_THAT(result, testing::HasSubstr("inject_test_plugin_not_found")); // The path, followed by the reason it couldn't be loaded
+    ASSERT_THAT(result, testing::Not(testing::EndsWith("loaded: ")));
+}
@@ -0,0 +1,220 @@
+#include "inject/registry.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    template<std::size_t N>
+    struct type
+    {
+    };
+
+    template<std::size_t... Ns>
+    std::vector<inject::type_id> get_type_ids(std::index_sequence<Ns...>)
+    {
+        return { inject::type_id::get<type<Ns>>()... };
+    }
+}
+
+TEST(registry, emplace_succeeds)
+{
+    // Arrange
+    inject::registry<int> registry;
+
+    // Action
+    auto result = registry.emplace(inject::type_id::get<int>(), 1);
+
+    // Assert
+    ASSERT_TRUE(result);
+    ASSERT_TRUE(registry.contains(inject::type_id::get<int>()));
+    ASSERT_EQ(1, *registry.find(inject::type_id::get<int>()));
+}
+
+TEST(registry, emplace_duplicate_fails)
+{
+    // Arrange
+    inject::registry<int> registry;
+
+    registry.emplace(inject::type_id::get<int>(), 1);
+
+    // Action
+    auto result = registry.emplace(inject::type_id::get<int>(), 2);
+
+    // Assert
+    ASSERT_FALSE(result);
+    ASSERT_EQ(1, *registry.find(inject::type_id::get<int>()));
+}
+
+TEST(registry, emplace_each_succeeds)
+{
+    // Arrange
+    inject::registry<int> registry;
+
+    auto ids = get_type_ids(std::make_index_sequence<4>());
+
+    // Action
+    auto result = registry.emplace_each({ ids[0], ids[1], ids[2], ids[3] }, 1);
+
+    // Assert
+    ASSERT_TRUE(result);
+
+    for (auto id : ids)
+    {
+        ASSERT_EQ(1, *registry.find(id));
+    }
+}
+
+TEST(registry, emplace_each_duplicate_fails)
+{
+    // Arrange
+    inject::registry<int> registry;
+
+    auto ids = get_type_ids(std::make_index_sequence<3>());
+
+    registry.emplace(ids[2], 1);
+
+    // Action
+    auto result = registry.emplace_each({ ids[0], ids[1], ids[2] }, 2);
+    auto result_repeated = registry.emplace_each({ ids[0], ids[0] }, 2);
+
+    // Assert
+    ASSERT_FALSE(result);
+    ASSERT_FALSE(result_repeated);
+    ASSERT_FALSE(registry.contains(ids[0]));
+    ASSERT_FALSE(registry.contains(ids[1]));
+    ASSERT_EQ(1, *registry.find(ids[2]));
+}
+
+TEST(registry, find_not_registered)
+{
+    // Arrange
+    inject::registry<int> registry;
+
+    // Action
+    auto result = registry.find(inject::type_id::get<int>());
+
+    // Assert
+    ASSERT_EQ(nullptr, result);
+    ASSERT_FALSE(registry.contains(inject::type_id::get<int>()));
+}
+
+TEST(registry, shard_index_distributes)
+{
+    // Arrange
+    auto ids = get_type_ids(std::make_index_sequence<64>());
+
+    // Action
+    std::set<std::size_t> shards;
+
+    for (auto id : ids)
+    {
+        shards.insert(inject::registry<int, 16>::shard_index(id));
+    }
+
+    // Assert
+    ASSERT_GE(shards.size(), 8u);
+}
+
+TEST(registry, concurrent_emplace_find_succeeds)
+{
+    // Arrange
+    inject::registry<std::size_t> registry;
+
+    auto ids = get_type_ids(std::make_index_sequence<64>());
+
+    // Action
+    std::atomic<std::size_t> errors = 0;
+    std::vector<std::thread> threads;
+
+    threads.emplace_back([&]()
+        {
+            for (std::size_t i = 0; i < ids.size(); ++i)
+            {
+                registry.emplace(ids[i], i);
+            }
+        });
+
+    for (std::size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]()
+            {
+                for (std::size_t i = 0; i < ids.size(); ++i)
+                {
+                    while (!registry.contains(ids[i]))
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    if (*registry.find(ids[i]) != i)
+                    {
+                        ++errors;
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Assert
+    ASSERT_EQ(0u, errors.load());
+}
+
+TEST(registry, concurrent_emplace_find_grows_succeeds)
+{
+    // Arrange - a single shard so that its table is replaced several times
+    inject::registry<std::size_t, 1> registry;
+
+    auto ids = get_type_ids(std::make_index_sequence<256>());
+
+    // Action
+    std::atomic<std::size_t> errors = 0;
+    std::vector<std::thread> threads;
+
+    threads.emplace_back([&]()
+        {
+            for (std::size_t i = 0; i < ids.size(); ++i)
+            {
+                registry.emplace(ids[i], i);
+            }
+        });
+
+    for (std::size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]()
+            {
+                for (std::size_t i = 0; i < ids.size(); ++i)
+                {
+                    while (!registry.contains(ids[i]))
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    for (std::size_t j = 0; j <= i; ++j) // Entries remain visible as the table grows
+                    {
+                        if (auto value = registry.find(ids[j]); value == nullptr || *value != j)
+                        {
+                            ++errors;
+                        }
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Assert
+    ASSERT_EQ(0u, errors.load());
+}
@@ -0,0 +1,244 @@
+#include "inject/trace.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+    std::string get_trace_path(const char* name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+}
+
+TEST(trace, save_load_succeeds)
+{
+    // Arrange
+    const auto path = get_trace_path("inject_trace_save_load.bin");
+
+    inject::resolution_trace trace({ inject::type_id::get<int>(), inject::type_id::get<std::string>() });
+
+    // Action
+    trace.save(path);
+
+    auto result = inject::resolution_trace::load(path);
+
+    // Assert
+    std::remove(path.c_str());
+
+    ASSERT_EQ(2u, result.types().size());
+    ASSERT_TRUE(result.types()[0] == inject::type_id::get<int>());
+    ASSERT_TRUE(result.types()[1] == inject::type_id::get<std::string>());
+}
+
+TEST(trace, load_not_found_empty)
+{
+    // Arrange
+    const auto path = get_trace_path("inject_trace_not_found.bin");
+
+    std::remove(path.c_str());
+
+    // Action
+    auto result = inject::resolution_trace::load(path);
+
+    // Assert
+    ASSERT_TRUE(result.types().empty());
+}
+
+TEST(trace, save_replace_succeeds)
+{
+    // Arrange
+    const auto path = get_trace_path("inject_trace_save_replace.bin");
+
+    inject::resolution_trace({ inject::type_id::get<int>(), inject::type_id::get<float>() }).save(path);
+
+    // Action
+    inject::resolution_trace({ inject::type_id::get<std::string>() }).save(path);
+
+    auto result = inject::resolution_trace::load(path);
+
+    // Assert
+    std::remove(path.c_str());
+
+    ASSERT_EQ(1u, result.types().size());
+    ASSERT_TRUE(result.types()[0] == inject::type_id::get<std::string>());
+    ASSERT_FALSE(std::filesystem::exists(path + ".tmp"));
+}
+
+TEST(trace, save_invalid_path_throws)
+{
+    // Arrange
+    const auto path = get_trace_path("inject_trace_missing_directory/trace.bin");
+
+    // Action / Assert
+    ASSERT_THROW(inject::resolution_trace().save(path), inject::factory_exception);
+}
+
+TEST(trace, load_invalid_empty)
+{
+    // Arrange
+    const auto path = get_trace_path("inject_trace_invalid.bin");
+
+    std::ofstream(path, std::ios::binary) << "not a trace file";
+
+    // Action
+    auto result = inject::resolution_trace::load(path);
+
+    // Assert
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(result.types().empty());
+}
+
+TEST(trace, load_short_empty)
+{
+    // Arrange
+    const auto path = get_trace_path("inject_trace_short.bin");
+
+    std::ofstream(path, std::ios::binary) << "INJT";
+
+    // Action
+    auto result = inject::resolution_trace::load(path);
+
+    // Assert
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(result.types().empty());
+}
+
+TEST(trace, load_truncated_empty)
+{
+    // Arrange
+    const auto path = get_trace_path("inject_trace_truncated.bin");
+
+    inject::resolution_trace({ inject::type_id::get<int>(), inject::type_id::get<float>() }).save(path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+    // Action
+    auto result = inject::resolution_trace::load(path);
+
+    // Assert
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(result.types().empty());
+}
+
+TEST(trace, record_succeeds)
+{
+    struct type_a
+    {
+    };
+
+    struct type_b
+    {
+    };
+
+    // Arrange
+    inject::container container;
+
+    container.register_shared<type_a>([](std::shared_ptr<type_b>) { return std::make_shared<type_a>(); });
+    container.register_shared<type_b>([]() { return std::make_shared<type_b>(); });
+    container.register_cached<int>([]() { return 1; });
+    container.register_unique<float>([]() { return std::make_unique<float>(1.0f); });
+
+    container.resolve<int>(); // Constructed before the trace is started
+
+    // Action
+    inject::trace_recorder recorder(container);
+
+    container.resolve_unique<float>();
+    container.resolve_shared<type_a>();
+    container.resolve_shared<type_a>();
+    container.resolve<int>();
+
+    auto result = recorder.stop();
+
+    // Assert
+    ASSERT_EQ(2u, result.types().size());
+    ASSERT_TRUE(result.types()[0] == inject::type_id::get<std::shared_ptr<type_b>>()); // Listed when construction completes, so dependencies come first
+    ASSERT_TRUE(result.types()[1] == inject::type_id::get<std::shared_ptr<type_a>>());
+}
+
+TEST(trace, prefetch_succeeds)
+{
+    struct type_a
+    {
+    };
+
+    // Arrange
+    inject::container container;
+
+    int count = 0;
+
+    container.register_shared<type_a>([&]()
+        {
+            ++count;
+            return std::make_shared<type_a>();
+        });
+
+    container.register_shared<int>([]() -> std::shared_ptr<int>
+        {
+            throw std::runtime_error("Not available");
+        });
+
+    inject::resolution_trace trace({ inject::type_id::get<std::shared_ptr<int>>(), inject::type_id::get<std::shared_ptr<float>>(), inject::type_id::get<std::shared_ptr<type_a>>() });
+
+    // Action
+    inject::prefetch(container, trace).wait();
+
+    auto result = container.resolve_shared<type_a>();
+
+    // Assert
+    ASSERT_NE(nullptr, result);
+    ASSERT_EQ(1, count); // Constructed by the prefetch, types that aren't registered or that throw are skipped
+    ASSERT_THROW(container.resolve_shared<int>(), std::runtime_error);
+}
+
+TEST(trace, prefetch_concurrent_resolve_succeeds)
+{
+    struct type_a
+    {
+    };
+
+    // Arrange
+    inject::container container;
+
+    std::atomic<int> count = 0;
+
+    container.register_shared<type_a>([&]()
+        {
+            ++count;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Likely to still be constructing when resolved
+            return std::make_shared<type_a>();
+        });
+
+    container.register_cached<int>([&]()
+        {
+            ++count;
+            return 1;
+        });
+
+    // Action
+    auto prefetch = inject::prefetch(container, inject::resolution_trace({ inject::type_id::get<int>(), inject::type_id::get<std::shared_ptr<type_a>>() }));
+
+    auto value = container.resolve<int>();
+    auto result = container.resolve_shared<type_a>();
+
+    prefetch.wait();
+
+    // Assert
+    ASSERT_EQ(1, value);
+    ASSERT_EQ(result, container.resolve_shared<type_a>());
+    ASSERT_EQ(2, count.load()); // Each instance is constructed once, by whichever thread gets to it first
+}
+
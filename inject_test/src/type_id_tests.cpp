@@ -0,0 +1,106 @@
+#include "inject/container.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <string>
+
+namespace
+{
+    struct config
+    {
+        std::string value;
+    };
+}
+
+// Defined in type_id_tests_other.cpp, which declares a different config type in its own anonymous namespace
+inject::type_id get_other_config_id();
+void register_other_config(inject::container& container);
+std::string resolve_other_config(inject::container& container);
+
+TEST(type_id, get_succeeds)
+{
+    // Action
+    auto result = inject::type_id::get<std::string>();
+
+    // Assert
+    ASSERT_TRUE(result == inject::type_id::get<std::string>());
+    ASSERT_TRUE(result != inject::type_id::get<int>());
+    ASSERT_TRUE(result.is_portable());
+}
+
+TEST(type_id, name_succeeds)
+{
+    // Action
+    auto result = inject::type_id::name<int>();
+
+    // Assert
+    ASSERT_EQ("int", result);
+}
+
+TEST(type_id, name_array_succeeds)
+{
+    // Action
+    auto result = std::string(inject::type_id::name<int[3]>());
+
+    // Assert
+    ASSERT_THAT(result, testing::StartsWith("int"));
+    ASSERT_THAT(result, testing::EndsWith("[3]"));
+}
+
+TEST(type_id, get_anonymous_namespace_distinct)
+{
+    // Action
+    auto result = inject::type_id::get<config>();
+
+    // Assert
+    ASSERT_TRUE(result != get_other_config_id());
+    ASSERT_TRUE(result == inject::type_id::get<config>());
+    ASSERT_FALSE(result.is_portable());
+}
+
+TEST(type_id, get_lambda_distinct)
+{
+    // Arrange
+    auto fn1 = []() { return 1; };
+    auto fn2 = []() { return 1; };
+
+    // Action
+    auto result1 = inject::type_id::get<decltype(fn1)>();
+    auto result2 = inject::type_id::get<decltype(fn2)>();
+
+    // Assert
+    ASSERT_TRUE(result1 != result2);
+    ASSERT_FALSE(result1.is_portable());
+}
+
+TEST(type_id, get_local_class_distinct)
+{
+    struct local
+    {
+    };
+
+    // Action
+    auto result = inject::type_id::get<local>();
+
+    // Assert
+    ASSERT_FALSE(result.is_portable());
+    ASSERT_FALSE(inject::type_id::get<std::shared_ptr<local>>().is_portable());
+}
+
+TEST(type_id, resolve_anonymous_namespace_succeeds)
+{
+    // Arrange
+    inject::container container;
+
+    container.register_type<config>([]() { return config{ "this" }; });
+    register_other_config(container);
+
+    // Action
+    auto result = container.resolve<config>();
+    auto result_other = resolve_other_config(container);
+
+    // Assert
+    ASSERT_EQ("this", result.value);
+    ASSERT_EQ("other", result_other);
+}
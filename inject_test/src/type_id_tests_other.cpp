@@ -0,0 +1,28 @@
+#include "inject/container.h"
+
+#include <string>
+
+// A second translation unit for type_id_tests, declaring a type with the same name in its own anonymous namespace
+
+namespace
+{
+    struct config
+    {
+        int value;
+    };
+}
+
+inject::type_id get_other_config_id()
+{
+    return inject::type_id::get<config>();
+}
+
+void register_other_config(inject::container& container)
+{
+    container.register_type<config>([]() { return config{ 1 }; });
+}
+
+std::string resolve_other_config(inject::container& container)
+{
+    return container.resolve<config>().value == 1 ? "other" : "";
+}